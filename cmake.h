@@ -0,0 +1,39 @@
+/* cmake.h.in. Creates cmake.h during a cmake run */
+
+/* Package information */
+#define PACKAGE           "shared"
+#define VERSION           "1.0.0"
+#define PACKAGE_BUGREPORT "support@gothenburgbitfactory.org"
+#define PACKAGE_NAME      "shared"
+#define PACKAGE_TARNAME   "shared"
+#define PACKAGE_VERSION   "1.0.0"
+#define PACKAGE_STRING    "shared 1.0.0"
+
+#define CMAKE_BUILD_TYPE  "Debug"
+
+/* Compiling platform */
+#define LINUX
+/* #undef DARWIN */
+/* #undef CYGWIN */
+/* #undef FREEBSD */
+/* #undef OPENBSD */
+/* #undef NETBSD */
+/* #undef DRAGONFLY */
+/* #undef SOLARIS */
+/* #undef KFREEBSD */
+/* #undef GNUHURD */
+/* #undef UNKNOWN */
+
+/* Found tm.tm_gmtoff struct member */
+/* #undef HAVE_TM_GMTOFF */
+
+/* Found st.st_birthtime struct member */
+/* #undef HAVE_ST_BIRTHTIME */
+
+/* Found strlcpy() */
+/* #undef HAVE_STRLCPY */
+
+/* Functions */
+/* #undef HAVE_GET_CURRENT_DIR_NAME */
+/* #undef HAVE_UUID_UNPARSE_LOWER */
+
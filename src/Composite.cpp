@@ -25,7 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <Composite.h>
-#include <sstream>
+#include <scan.h>
 #include <stack>
 #include <utf8.h>
 
@@ -95,12 +95,27 @@ std::string Composite::str () const
       colors.resize     (offset + len, 0);
     }
 
-    // Copy in the layer characters and color indexes.
+    // Copy in the layer characters and color indexes.  Runs of ASCII are
+    // copied without decoding.
     std::string::size_type cursor = 0;
     int character;
     int count = 0;
-    while ((character = utf8_next_char (text, cursor)))
+    while (true)
     {
+      if (text[cursor] > 0)
+      {
+        auto end = cursor + scan_ascii (text.data () + cursor, text.length () - cursor);
+        for (; cursor < end; ++cursor)
+        {
+          characters[offset + count] = text[cursor];
+          colors    [offset + count] = layer + 1;
+          ++count;
+        }
+      }
+
+      if (! (character = utf8_next_char (text, cursor)))
+        break;
+
       characters[offset + count] = character;
       colors    [offset + count] = layer + 1;
       ++count;
@@ -109,7 +124,7 @@ std::string Composite::str () const
 
   // Now walk the character and color vector, emitting every character and
   // every detected color change.
-  std::stringstream out;
+  std::string out;
   int prev_color = 0;
   for (unsigned int i = 0; i < characters.size (); ++i)
   {
@@ -117,24 +132,27 @@ std::string Composite::str () const
     if (prev_color != colors[i])
     {
       if (prev_color)
-        out << std::get <2> (_layers[prev_color - 1]).end ();
+        out += std::get <2> (_layers[prev_color - 1]).end ();
 
       if (colors[i])
-        out << std::get <2> (_layers[colors[i] - 1]).code ();
+        out += std::get <2> (_layers[colors[i] - 1]).code ();
       else
-        out << std::get <2> (_layers[prev_color - 1]).end ();
+        out += std::get <2> (_layers[prev_color - 1]).end ();
 
       prev_color = colors[i];
     }
 
-    out << utf8_character (characters[i]);
+    if (characters[i] < 0x80)
+      out += static_cast <char> (characters[i]);
+    else
+      out += utf8_character (characters[i]);
   }
 
   // Terminate the color codes, if necessary.
   if (prev_color)
-    out << std::get <2> (_layers[prev_color - 1]).end ();
+    out += std::get <2> (_layers[prev_color - 1]).end ();
 
-  return out.str ();
+  return out;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
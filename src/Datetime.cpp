@@ -25,14 +25,19 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <Datetime.h>
+#include <DatetimeFormat.h>
+#include <Timezone.h>
 #include <algorithm>
 #include <cassert>
+#include <charconv>
 #include <cstdlib>
+#include <exception>
 #include <format.h>
-#include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <shared.h>
-#include <sstream>
+#include <system_error>
+#include <thread>
 #include <unicode.h>
 #include <utf8.h>
 
@@ -59,6 +64,10 @@ static std::vector <std::string> monthNames {
   "november",
   "december"};
 
+// A column is parsed in runs of no fewer than this many dates per thread, so
+// that short columns are not spread thinly across threads.
+static const std::size_t minimumRun = 4096;
+
 int Datetime::weekstart = 1; // Monday, per ISO-8601.
 int Datetime::minimumMatchLength = 3;
 bool Datetime::isoEnabled            = true;
@@ -75,6 +84,209 @@ bool Datetime::standaloneTimeEnabled = true;
 // - 1st, 2nd, 3rd, ... is always converted to date before now
 bool Datetime::timeRelative = true;
 
+////////////////////////////////////////////////////////////////////////////////
+// UTC needs no time zone rules, and so is calculated here.
+static struct tm* utcTime (time_t when, struct tm& result)
+{
+  int64_t days    = when / 86400;
+  int64_t seconds = when % 86400;
+  if (seconds < 0)
+  {
+    seconds += 86400;
+    --days;
+  }
+
+  int year, month, day;
+  Datetime::civilFromDays (days, year, month, day);
+
+  result = {};
+  result.tm_year = year - 1900;
+  result.tm_mon  = month - 1;
+  result.tm_mday = day;
+  result.tm_hour = seconds / 3600;
+  result.tm_min  = seconds % 3600 / 60;
+  result.tm_sec  = seconds % 60;
+  result.tm_wday = (days % 7 + 11) % 7;       // 1970-01-01 was a Thursday.
+  result.tm_yday = days - Datetime::daysFromCivil (year, 1, 1);
+  return &result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A reentrant replacement for localtime, which shares one static buffer
+// between all threads.  With a zone, the conversion needs no libc at all.
+static struct tm* localTime (time_t when, struct tm& result, const Timezone* zone)
+{
+  if (zone)
+  {
+    auto& type = zone->at (when);
+    utcTime (when + type.offset, result);
+    result.tm_isdst = type.dst;
+    return &result;
+  }
+
+#ifdef _WIN32
+  localtime_s (&result, &when);
+#else
+  localtime_r (&when, &result);
+#endif
+  return &result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The seconds since the epoch of a broken-down time, as though it were UTC.
+// As for mktime, fields out of range carry over into the next field up.
+static int64_t civilSeconds (const struct tm* t)
+{
+  int years  = t->tm_mon / 12;
+  int months = t->tm_mon % 12;
+  if (months < 0)
+  {
+    months += 12;
+    --years;
+  }
+
+  return (Datetime::daysFromCivil (t->tm_year + 1900 + years, months + 1, 1) + t->tm_mday - 1) * 86400
+         + (int64_t) t->tm_hour * 3600
+         + (int64_t) t->tm_min  *   60
+         + t->tm_sec;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Converts local seconds, as from civilSeconds, to a time_t.  This is the one
+// step that needs the time zone rules.  It looks for a UTC offset that gives
+// back the local time it was applied to, starting from the offset found last
+// time, and so costs one localtime_r call when the offset is unchanged.  A
+// wrong starting offset, as on a new thread, can take two more calls to
+// settle.  Local times skipped by a change to summer time have no such
+// offset, and the search then alternates between the offsets either side of
+// the change.  They are taken at the offset before the change, as mktime
+// does, and so 02:30 becomes 03:30.  Local times repeated by the change back
+// are taken at whichever offset was last seen, also as mktime does.
+static time_t fromLocal (int64_t local, const Timezone* zone)
+{
+  if (zone)
+    return zone->toUTC (local);
+
+  static thread_local int64_t offset = 0;
+
+  struct tm broken;
+  int64_t tried = offset;
+  int64_t previous = offset;
+  for (int i = 0; i < 3; ++i)
+  {
+    time_t when = local - tried;
+    int64_t found = civilSeconds (localTime (when, broken, nullptr)) - when;
+    if (found == tried)
+    {
+      offset = found;
+      return when;
+    }
+
+    previous = tried;
+    tried = found;
+  }
+
+  // In a gap, the two offsets either side of it each give a time on the far
+  // side of the change.  The later of the two is the one mktime gives.
+  return std::max ((time_t) (local - previous), (time_t) (local - tried));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replaces mktime, for a tm with tm_isdst of -1.  Unlike mktime, this does not
+// normalize the fields of t.
+static time_t fromLocal (const struct tm* t, const Timezone* zone)
+{
+  return fromLocal (civilSeconds (t), zone);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads the fourteen digits of a date and time at the given offsets of text,
+// and checks them as the grammar and validate would.
+static bool fixedWidth (
+  std::string_view text,
+  const int (&positions)[14],
+  int& year,
+  int& month,
+  int& day,
+  int& seconds)
+{
+  // All fourteen digits are checked together, with one branch.
+  int value[14];
+  unsigned int bad = 0;
+  for (int i = 0; i < 14; ++i)
+  {
+    value[i] = text[positions[i]] - '0';
+    bad |= static_cast <unsigned int> (value[i]) > 9;
+  }
+
+  if (bad)
+    return false;
+
+  year  = value[0] * 1000 + value[1] * 100 + value[2] * 10 + value[3];
+  month = value[4] * 10 + value[5];
+  day   = value[6] * 10 + value[7];
+
+  int hour   = value[8]  * 10 + value[9];
+  int minute = value[10] * 10 + value[11];
+  int second = value[12] * 10 + value[13];
+
+  // parse_year takes only years after 1969.
+  static const int days[12] {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if (year < 1970                                                                  ||
+      month < 1 || month > 12                                                      ||
+      day < 1   || day > days[month - 1] + (month == 2 && Datetime::leapYear (year)) ||
+      hour > 23 || minute > 59 || second > 59)
+    return false;
+
+  seconds = hour * 3600 + minute * 60 + second;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes value, which is not negative, as exactly width digits.
+static char* digits (char* out, int value, int width)
+{
+  for (int i = width - 1; i >= 0; --i, value /= 10)
+    out[i] = '0' + value % 10;
+
+  return out + width;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes a year as four digits, or in full when it does not fit in four.
+static char* yearDigits (char* out, int value)
+{
+  if (value >= 0 && value <= 9999)
+    return digits (out, value, 4);
+
+  return std::to_chars (out, out + 16, value).ptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The forms that take a format string compile it once per thread, and again
+// only when a different format is used, so that a column of dates in one
+// format is not compiled for each date.
+static const DatetimeFormat& compiled (const std::string& format)
+{
+  static thread_local DatetimeFormat last {""};
+  if (last.str () != format)
+    last = DatetimeFormat (format);
+
+  return last;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Datetime::Context::Context ()
+: weekstart (Datetime::weekstart)
+, minimumMatchLength (Datetime::minimumMatchLength)
+, isoEnabled (Datetime::isoEnabled)
+, standaloneDateEnabled (Datetime::standaloneDateEnabled)
+, standaloneTimeEnabled (Datetime::standaloneTimeEnabled)
+, timeRelative (Datetime::timeRelative)
+, timezone (nullptr)
+{
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Datetime::Datetime ()
 {
@@ -82,6 +294,14 @@ Datetime::Datetime ()
   _date = time (nullptr);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Datetime::Datetime (const Context& context)
+: _context (context)
+{
+  clear ();
+  _date = time (nullptr);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Datetime::Datetime (const std::string& input, const std::string& format)
 {
@@ -91,6 +311,32 @@ Datetime::Datetime (const std::string& input, const std::string& format)
     throw ::format ("'{1}' is not a valid date in the '{2}' format.", input, format);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Datetime::Datetime (
+  const std::string& input,
+  const std::string& format,
+  const Context& context)
+: _context (context)
+{
+  clear ();
+  std::string::size_type start = 0;
+  if (! parse (input, start, format, context))
+    throw ::format ("'{1}' is not a valid date in the '{2}' format.", input, format);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Datetime::Datetime (
+  const std::string& input,
+  const DatetimeFormat& format,
+  const Context& context)
+: _context (context)
+{
+  clear ();
+  std::string::size_type start = 0;
+  if (! parse (input, start, format, context))
+    throw ::format ("'{1}' is not a valid date in the '{2}' format.", input, format.str ());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Datetime::Datetime (const time_t t)
 {
@@ -107,15 +353,7 @@ Datetime::Datetime (const int y, const int m, const int d)
   assert (d >= 1 && d <= 31);
 
   clear ();
-
-  // Error if not valid.
-  struct tm t {};
-  t.tm_isdst = -1;   // Requests that mktime determine summer time effect.
-  t.tm_mday  = d;
-  t.tm_mon   = m - 1;
-  t.tm_year  = y - 1900;
-
-  _date = mktime (&t);
+  _date = fromLocal (daysFromCivil (y, m, d) * 86400, _context.timezone);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -131,30 +369,52 @@ Datetime::Datetime (const int y,  const int m,  const int d,
   assert (se >= 0 && se < 60);
 
   clear ();
+  _date = fromLocal (daysFromCivil (y, m, d) * 86400 + hr * 3600 + mi * 60 + se, _context.timezone);
+}
 
-  // Error if not valid.
-  struct tm t {};
-  t.tm_isdst = -1;   // Requests that mktime determine summer time effect.
-  t.tm_mday  = d;
-  t.tm_mon   = m - 1;
-  t.tm_year  = y - 1900;
-  t.tm_hour  = hr;
-  t.tm_min   = mi;
-  t.tm_sec   = se;
+////////////////////////////////////////////////////////////////////////////////
+// Parses with the statics as they are now.
+bool Datetime::parse (
+  const std::string& input,
+  std::string::size_type& start,
+  const std::string& format)
+{
+  return parse (input, start, format, Context ());
+}
 
-  _date = mktime (&t);
+////////////////////////////////////////////////////////////////////////////////
+bool Datetime::parse (
+  const std::string& input,
+  std::string::size_type& start,
+  const std::string& format,
+  const Context& context)
+{
+  return parse (input, start, compiled (format), context);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool Datetime::parse (
   const std::string& input,
   std::string::size_type& start,
-  const std::string& format)
+  const DatetimeFormat& format,
+  const Context& context)
 {
-  auto i = start;
-  Pig pig (input);
-  if (i)
-    pig.skipN (static_cast <int> (i));
+  return parse_text (input, start, format, context);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Parses with the given settings, which are kept for later formatting.
+bool Datetime::parse_text (
+  std::string_view input,
+  std::string::size_type& start,
+  const DatetimeFormat& format,
+  const Context& context)
+{
+  _context = context;
+
+  Pig pig {input};
+  if (! pig.seek (start))
+    return false;
 
   auto checkpoint = pig.cursor ();
 
@@ -166,7 +426,7 @@ bool Datetime::parse (
     return true;
   }
 
-  if (parse_formatted (pig, format))
+  if (format.parse (pig, *this))
   {
     // Check the values and determine time_t.
     if (validate ())
@@ -177,20 +437,28 @@ bool Datetime::parse (
     }
   }
 
+  // Then the compact UTC form, which is how Taskwarrior stores dates.
+  if (parse_compact_utc (input.substr (pig.cursor ())))
+  {
+    // ::validate and ::resolve are not needed in this case.
+    start = pig.cursor () + 16;
+    return true;
+  }
+
   // Allow parse_date_time and parse_date_time_ext regardless of
-  // Datetime::isoEnabled setting, because these formats are relied upon by
+  // the isoEnabled setting, because these formats are relied upon by
   // the 'import' command, JSON parser and hook system.
   if (parse_date_time_ext   (pig) || // Strictest first.
       parse_date_time       (pig) ||
-      (Datetime::isoEnabled &&
-       (                                    parse_date_ext      (pig)  ||
-        (Datetime::standaloneDateEnabled && parse_date          (pig)) ||
-                                            parse_time_utc_ext  (pig)  ||
-                                            parse_time_utc      (pig)  ||
-                                            parse_time_off_ext  (pig)  ||
-                                            parse_time_ext      (pig)  ||
-        (Datetime::standaloneTimeEnabled && parse_time          (pig)) || // Time last, as it is the most permissive.
-        (Datetime::standaloneTimeEnabled && parse_time_off      (pig))
+      (_context.isoEnabled &&
+       (                                   parse_date_ext      (pig)  ||
+        (_context.standaloneDateEnabled && parse_date          (pig)) ||
+                                           parse_time_utc_ext  (pig)  ||
+                                           parse_time_utc      (pig)  ||
+                                           parse_time_off_ext  (pig)  ||
+                                           parse_time_ext      (pig)  ||
+        (_context.standaloneTimeEnabled && parse_time          (pig)) || // Time last, as it is the most permissive.
+        (_context.standaloneTimeEnabled && parse_time_off      (pig))
        )
       )
      )
@@ -216,13 +484,28 @@ bool Datetime::parse (
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const Datetime::Context& Datetime::context () const
+{
+  return _context;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A Datetime for the given time, with the settings of this one.
+Datetime Datetime::at (time_t date) const
+{
+  Datetime result (_context);
+  result._date = date;
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Datetime::clear ()
 {
   _year    = 0;
   _month   = 0;
   _week    = 0;
-  _weekday = Datetime::weekstart;
+  _weekday = _context.weekstart;
   _julian  = 0;
   _day     = 0;
   _seconds = 0;
@@ -231,322 +514,6 @@ void Datetime::clear ()
   _date    = 0;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-bool Datetime::parse_formatted (Pig& pig, const std::string& format)
-{
-  // Short-circuit on missing format.
-  if (format.empty ())
-    return false;
-
-  auto checkpoint = pig.cursor ();
-
-  int month  {-1};   // So we can check later.
-  int day    {-1};
-  int year   {-1};
-  int hour   {-1};
-  int minute {-1};
-  int second {-1};
-
-  // For parsing, unused.
-  int wday   {-1};
-  int week   {-1};
-
-  for (unsigned int f = 0; f < format.length (); ++f)
-  {
-    switch (format[f])
-    {
-    case 'm':
-      if (pig.getDigit (month))
-      {
-        if (month == 0)
-          pig.getDigit (month);
-
-        if (month == 1)
-          if (pig.getDigit (month))
-            month += 10;
-      }
-      else
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'M':
-      if (! pig.getDigit2 (month))
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'd':
-      if (pig.getDigit (day))
-      {
-        if (day == 0)
-          pig.getDigit (day);
-
-        if (day == 1 || day == 2 || day == 3)
-        {
-          int tens = day;
-          if (pig.getDigit (day))
-            day += 10 * tens;
-        }
-      }
-      else
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'D':
-      if (! pig.getDigit2 (day))
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'y':
-      if (! pig.getDigit2 (year))
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      year += 2000;
-      break;
-
-    case 'Y':
-      if (! pig.getDigit4 (year))
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'h':
-      if (pig.getDigit (hour))
-      {
-        if (hour == 0)
-          pig.getDigit (hour);
-
-        if (hour == 1 || hour == 2)
-        {
-          int tens = hour;
-          if (pig.getDigit (hour))
-            hour += 10 * tens;
-        }
-      }
-      else
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'H':
-      if (! pig.getDigit2 (hour))
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'n':
-      if (pig.getDigit (minute))
-      {
-        if (minute == 0)
-          pig.getDigit (minute);
-
-        if (minute < 6)
-        {
-          int tens = minute;
-          if (pig.getDigit (minute))
-            minute += 10 * tens;
-        }
-      }
-      else
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'N':
-      if (! pig.getDigit2 (minute))
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 's':
-      if (pig.getDigit (second))
-      {
-        if (second == 0)
-          pig.getDigit (second);
-
-        if (second < 6)
-        {
-          int tens = second;
-          if (pig.getDigit (second))
-            second += 10 * tens;
-        }
-      }
-      else
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'S':
-      if (! pig.getDigit2 (second))
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'v':
-      if (pig.getDigit (week))
-      {
-        if (week == 0)
-          pig.getDigit (week);
-
-        if (week < 6)
-        {
-          int tens = week;
-          if (pig.getDigit (week))
-            week += 10 * tens;
-        }
-      }
-      else
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'V':
-      if (! pig.getDigit2 (week))
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-
-    case 'a':
-      wday = Datetime::dayOfWeek (pig.str ().substr (0, 3));
-      if (wday == -1)
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-
-      pig.skipN (3);
-      break;
-
-    case 'A':
-      {
-        std::string dayName;
-        if (pig.getUntil (format[f + 1], dayName))
-        {
-          wday = Datetime::dayOfWeek (dayName);
-          if (wday == -1)
-          {
-            pig.restoreTo (checkpoint);
-            return false;
-          }
-        }
-      }
-      break;
-
-    case 'b':
-      month = Datetime::monthOfYear (pig.str ().substr (0, 3));
-      if (month == -1)
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-
-      pig.skipN (3);
-      break;
-
-    case 'B':
-      {
-        std::string monthName;
-        if (pig.getUntil (format[f + 1], monthName))
-        {
-          month = Datetime::monthOfYear (monthName);
-          if (month == -1)
-          {
-            pig.restoreTo (checkpoint);
-            return false;
-          }
-        }
-      }
-      break;
-
-    default:
-      if (! pig.skip (format[f]))
-      {
-        pig.restoreTo (checkpoint);
-        return false;
-      }
-      break;
-    }
-  }
-
-  // It is possible that the format='Y-M-D', and the input is Y-M-DTH:N:SZ, and
-  // this should not be considered a match.
-  if (! pig.eos () && ! unicodeWhitespace (pig.peek ()))
-  {
-    pig.restoreTo (checkpoint);
-    return false;
-  }
-
-  // Missing values are filled in from the current date.
-  if (year == -1)
-  {
-    Datetime now;
-    year = now.year ();
-    if (month == -1)
-    {
-      month = now.month ();
-      if (day == -1)
-      {
-        day = now.day ();
-        if (hour == -1)
-        {
-          hour = now.hour ();
-          if (minute == -1)
-          {
-            minute = now.minute ();
-            if (second == -1)
-              second = now.second ();
-          }
-        }
-      }
-    }
-  }
-
-  // Any remaining undefined values are assigned defaults.
-  if (month  == -1) month  = 1;
-  if (day    == -1) day    = 1;
-  if (hour   == -1) hour   = 0;
-  if (minute == -1) minute = 0;
-  if (second == -1) second = 0;
-
-  _year    = year;
-  _month   = month;
-  _day     = day;
-  _seconds = (hour * 3600) + (minute * 60) + second;
-
-  return true;
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 // Note how these are all single words.
 //
@@ -712,6 +679,65 @@ bool Datetime::parse_epoch (Pig& pig)
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// YYYYMMDDThhmmssZ
+//
+// Exactly what parse_date_time, validate and resolve together accept and
+// produce for this form, but read at fixed offsets, without backtracking.
+// Anything else, such as a time with no seconds, is left to them.
+bool Datetime::parse_compact_utc (std::string_view text)
+{
+  static const int positions[14] {0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 13, 14};
+
+  int year, month, day, seconds;
+  if (text.length () < 16 ||
+      text[8]  != 'T'     ||
+      text[15] != 'Z'     ||
+      (text.length () > 16 && unicodeLatinDigit (text[16])) ||
+      ! fixedWidth (text, positions, year, month, day, seconds))
+    return false;
+
+  _year    = year;
+  _month   = month;
+  _day     = day;
+  _seconds = seconds;
+  _utc     = true;
+  _date    = daysFromCivil (year, month, day) * 86400 + seconds;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// YYYY-MM-DDThh:mm:ss
+// YYYY-MM-DDThh:mm:ssZ
+//
+// The whole of text, read as parse_compact_utc reads its form, with the
+// result that parse_date_time_ext, validate and resolve give.
+bool Datetime::parse_extended (std::string_view text)
+{
+  static const int positions[14] {0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18};
+
+  bool utc = text.length () == 20 && text[19] == 'Z';
+  int year, month, day, seconds;
+  if ((text.length () != 19 && ! utc) ||
+      text[4]  != '-'                 ||
+      text[7]  != '-'                 ||
+      text[10] != 'T'                 ||
+      text[13] != ':'                 ||
+      text[16] != ':'                 ||
+      ! fixedWidth (text, positions, year, month, day, seconds))
+    return false;
+
+  _year    = year;
+  _month   = month;
+  _day     = day;
+  _seconds = seconds;
+  _utc     = utc;
+
+  int64_t local = daysFromCivil (year, month, day) * 86400 + seconds;
+  _date = utc ? local : fromLocal (local, _context.timezone);
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // date_ext 'T' time_utc_ext 'Z'
 // date_ext 'T' time_off_ext
@@ -761,7 +787,7 @@ bool Datetime::parse_date_ext (Pig& pig)
       if (! (pig.skip ('-') &&
              parse_weekday (pig, weekday)))
       {
-        weekday = Datetime::weekstart;
+        weekday = _context.weekstart;
       }
 
       if (! unicodeLatinDigit (pig.peek ()))
@@ -974,7 +1000,7 @@ bool Datetime::parse_date (Pig& pig)
         parse_week (pig, week))
     {
       if (! (parse_weekday (pig, weekday)))
-        weekday = Datetime::weekstart;
+        weekday = _context.weekstart;
 
       if (! unicodeLatinDigit (pig.peek ()))
       {
@@ -1221,8 +1247,8 @@ bool Datetime::parse_weekday (Pig& pig, int& value)
 
   int weekday;
   if (pig.getDigit (weekday) &&
-      weekday >= Datetime::weekstart &&
-      weekday <= (Datetime::weekstart == 1 ? 7 : 6))
+      weekday >= _context.weekstart &&
+      weekday <= (_context.weekstart == 1 ? 7 : 6))
   {
     value = weekday;
     return true;
@@ -1351,19 +1377,20 @@ bool Datetime::initializeYesterday (Pig& pig)
 
   std::string token;
   if (pig.skipPartial ("yesterday", token) &&
-      token.length () >= static_cast <std::string::size_type> (Datetime::minimumMatchLength))
+      token.length () >= static_cast <std::string::size_type> (_context.minimumMatchLength))
   {
     auto following = pig.peek ();
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_isdst = -1;
       t->tm_mday -= 1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1380,18 +1407,19 @@ bool Datetime::initializeToday (Pig& pig)
 
   std::string token;
   if (pig.skipPartial ("today", token) &&
-      token.length () >= static_cast <std::string::size_type> (Datetime::minimumMatchLength))
+      token.length () >= static_cast <std::string::size_type> (_context.minimumMatchLength))
   {
     auto following = pig.peek ();
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
 
       return true;
     }
@@ -1409,19 +1437,20 @@ bool Datetime::initializeTomorrow (Pig& pig)
 
   std::string token;
   if (pig.skipPartial ("tomorrow", token) &&
-      token.length () >= static_cast <std::string::size_type> (Datetime::minimumMatchLength))
+      token.length () >= static_cast <std::string::size_type> (_context.minimumMatchLength))
   {
     auto following = pig.peek ();
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday++;
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1460,13 +1489,14 @@ bool Datetime::initializeOrdinal (Pig& pig)
             remainder1 > 3) && character1 == 't' && character2 == 'h'))
       {
         time_t now = time (nullptr);
-        struct tm* t = localtime (&now);
+        struct tm now_tm;
+        struct tm* t = localTime (now, now_tm, _context.timezone);
 
         int y = t->tm_year + 1900;
         int m = t->tm_mon + 1;
         int d = t->tm_mday;
 
-        if (timeRelative && (1 <= number && number <= d))
+        if (_context.timeRelative && (1 <= number && number <= d))
         {
           if (++m > 12)
           {
@@ -1474,7 +1504,7 @@ bool Datetime::initializeOrdinal (Pig& pig)
             y++;
           }
         }
-        else if (!timeRelative && (d < number && number <= daysInMonth (y, m)))
+        else if (!_context.timeRelative && (d < number && number <= daysInMonth (y, m)))
         {
           if (--m < 1)
           {
@@ -1489,7 +1519,7 @@ bool Datetime::initializeOrdinal (Pig& pig)
         t->tm_year = y - 1900;
         t->tm_isdst = -1;
 
-        _date = mktime (t);
+        _date = fromLocal (t, _context.timezone);
 
         return true;
       }
@@ -1510,7 +1540,7 @@ bool Datetime::initializeDayName (Pig& pig)
   for (int day = 0; day <= 7; ++day)   // Deliberate <= so that 'sunday' is either 0 or 7.
   {
     if (pig.skipPartial (dayNames[day % 7], token, true) &&
-        token.length () >= static_cast <std::string::size_type> (Datetime::minimumMatchLength))
+        token.length () >= static_cast <std::string::size_type> (_context.minimumMatchLength))
     {
       auto following = pig.peek ();
       if (! unicodeLatinAlpha (following) &&
@@ -1519,20 +1549,21 @@ bool Datetime::initializeDayName (Pig& pig)
           following != '=')
       {
         time_t now = time (nullptr);
-        struct tm* t = localtime (&now);
+        struct tm now_tm;
+        struct tm* t = localTime (now, now_tm, _context.timezone);
 
         if (t->tm_wday >= day)
         {
-          t->tm_mday += day - t->tm_wday + (timeRelative ? 7 : 0);
+          t->tm_mday += day - t->tm_wday + (_context.timeRelative ? 7 : 0);
         }
         else
         {
-          t->tm_mday += day - t->tm_wday - (timeRelative ? 0 : 7);
+          t->tm_mday += day - t->tm_wday - (_context.timeRelative ? 0 : 7);
         }
 
         t->tm_hour = t->tm_min = t->tm_sec = 0;
         t->tm_isdst = -1;
-        _date = mktime (t);
+        _date = fromLocal (t, _context.timezone);
         return true;
       }
     }
@@ -1553,7 +1584,7 @@ bool Datetime::initializeMonthName (Pig& pig)
   for (int month = 0; month < 12; ++month)
   {
     if (pig.skipPartial (monthNames[month], token, true) &&
-        token.length () >= static_cast <std::string::size_type> (Datetime::minimumMatchLength))
+        token.length () >= static_cast <std::string::size_type> (_context.minimumMatchLength))
     {
       auto following = pig.peek ();
       if (! unicodeLatinAlpha (following) &&
@@ -1562,9 +1593,10 @@ bool Datetime::initializeMonthName (Pig& pig)
           following != '=')
       {
         time_t now = time (nullptr);
-        struct tm* t = localtime (&now);
+        struct tm now_tm;
+        struct tm* t = localTime (now, now_tm, _context.timezone);
 
-        if (t->tm_mon >= month && timeRelative)
+        if (t->tm_mon >= month && _context.timeRelative)
         {
           t->tm_year++;
         }
@@ -1573,7 +1605,7 @@ bool Datetime::initializeMonthName (Pig& pig)
         t->tm_mday = 1;
         t->tm_hour = t->tm_min = t->tm_sec = 0;
         t->tm_isdst = -1;
-        _date = mktime (t);
+        _date = fromLocal (t, _context.timezone);
         return true;
       }
     }
@@ -1593,26 +1625,27 @@ bool Datetime::initializeLater (Pig& pig)
 
   std::string token;
   if ((pig.skipPartial ("later", token) &&
-      token.length () >= static_cast <std::string::size_type> (Datetime::minimumMatchLength))
+      token.length () >= static_cast <std::string::size_type> (_context.minimumMatchLength))
 
       ||
 
      (pig.skipPartial ("someday", token) &&
-      token.length () >= static_cast <std::string::size_type> (std::max (Datetime::minimumMatchLength, 4))))
+      token.length () >= static_cast <std::string::size_type> (std::max (_context.minimumMatchLength, 4))))
   {
     auto following = pig.peek ();
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_year = 8099;  // Year 9999
       t->tm_mon = 11;
       t->tm_mday = 30;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1634,12 +1667,13 @@ bool Datetime::initializeSopd (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_isdst = -1;
       t->tm_mday -= 1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1661,11 +1695,12 @@ bool Datetime::initializeSod (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1687,12 +1722,13 @@ bool Datetime::initializeSond (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday++;
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1714,12 +1750,13 @@ bool Datetime::initializeEopd (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1741,13 +1778,14 @@ bool Datetime::initializeEod (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday++;
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1769,13 +1807,14 @@ bool Datetime::initializeEond (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday += 2;
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1797,7 +1836,8 @@ bool Datetime::initializeSopw (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
       int extra = (t->tm_wday + 6) % 7;
@@ -1805,7 +1845,7 @@ bool Datetime::initializeSopw (Pig& pig)
       t->tm_mday -= 7;
 
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1827,14 +1867,15 @@ bool Datetime::initializeSow (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
       int extra = (t->tm_wday + 6) % 7;
       t->tm_mday -= extra;
 
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1856,7 +1897,8 @@ bool Datetime::initializeSonw (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
       int extra = (t->tm_wday + 6) % 7;
@@ -1864,7 +1906,7 @@ bool Datetime::initializeSonw (Pig& pig)
       t->tm_mday += 7;
 
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1886,7 +1928,8 @@ bool Datetime::initializeEopw (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
 
@@ -1894,7 +1937,7 @@ bool Datetime::initializeEopw (Pig& pig)
       t->tm_mday -= extra;
 
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1916,7 +1959,8 @@ bool Datetime::initializeEow (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
 
@@ -1925,7 +1969,7 @@ bool Datetime::initializeEow (Pig& pig)
       t->tm_mday += 7;
 
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1947,7 +1991,8 @@ bool Datetime::initializeEonw (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
 
@@ -1955,7 +2000,7 @@ bool Datetime::initializeEonw (Pig& pig)
       t->tm_mday += 14 - extra;
 
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -1977,12 +2022,13 @@ bool Datetime::initializeSopww (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday += -6 - t->tm_wday;
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2004,12 +2050,13 @@ bool Datetime::initializeSoww (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday += 1 - t->tm_wday;
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2031,12 +2078,13 @@ bool Datetime::initializeSonww (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday += 8 - t->tm_wday;
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2058,13 +2106,14 @@ bool Datetime::initializeEopww (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday -= t->tm_wday + 1;
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2086,13 +2135,14 @@ bool Datetime::initializeEoww (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday += 6 - t->tm_wday;
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2114,13 +2164,14 @@ bool Datetime::initializeEonww (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mday += 13 - t->tm_wday;
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2142,7 +2193,8 @@ bool Datetime::initializeSopm (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
@@ -2156,7 +2208,7 @@ bool Datetime::initializeSopm (Pig& pig)
 
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2178,12 +2230,13 @@ bool Datetime::initializeSom (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2205,7 +2258,8 @@ bool Datetime::initializeSonm (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
@@ -2218,7 +2272,7 @@ bool Datetime::initializeSonm (Pig& pig)
 
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2240,13 +2294,14 @@ bool Datetime::initializeEopm (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2268,7 +2323,8 @@ bool Datetime::initializeEom (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
@@ -2282,7 +2338,7 @@ bool Datetime::initializeEom (Pig& pig)
 
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2304,7 +2360,8 @@ bool Datetime::initializeEonm (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
@@ -2317,7 +2374,7 @@ bool Datetime::initializeEonm (Pig& pig)
       }
 
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2339,7 +2396,8 @@ bool Datetime::initializeSopq (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mon -= t->tm_mon % 3;
       t->tm_mon -= 3;
@@ -2352,7 +2410,7 @@ bool Datetime::initializeSopq (Pig& pig)
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2374,13 +2432,14 @@ bool Datetime::initializeSoq (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_mon -= t->tm_mon % 3;
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2402,7 +2461,8 @@ bool Datetime::initializeSonq (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mon += 3 - (t->tm_mon % 3);
       if (t->tm_mon > 11)
@@ -2414,7 +2474,7 @@ bool Datetime::initializeSonq (Pig& pig)
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2436,14 +2496,15 @@ bool Datetime::initializeEopq (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
       t->tm_mon -= t->tm_mon % 3;
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2465,7 +2526,8 @@ bool Datetime::initializeEoq (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_mon += 3 - (t->tm_mon % 3);
       if (t->tm_mon > 11)
@@ -2478,7 +2540,7 @@ bool Datetime::initializeEoq (Pig& pig)
       t->tm_sec = -1;
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2500,7 +2562,8 @@ bool Datetime::initializeEonq (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
@@ -2513,7 +2576,7 @@ bool Datetime::initializeEonq (Pig& pig)
 
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2535,14 +2598,15 @@ bool Datetime::initializeSopy (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_mon = 0;
       t->tm_mday = 1;
       t->tm_year--;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2564,13 +2628,14 @@ bool Datetime::initializeSoy (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_mon = 0;
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2592,14 +2657,15 @@ bool Datetime::initializeSony (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
       t->tm_mon = 0;
       t->tm_mday = 1;
       t->tm_year++;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2621,14 +2687,15 @@ bool Datetime::initializeEopy (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
       t->tm_mon = 0;
       t->tm_mday = 1;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2650,7 +2717,8 @@ bool Datetime::initializeEoy (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
@@ -2658,7 +2726,7 @@ bool Datetime::initializeEoy (Pig& pig)
       t->tm_mday = 1;
       t->tm_year++;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2680,7 +2748,8 @@ bool Datetime::initializeEony (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       t->tm_hour = t->tm_min = 0;
       t->tm_sec = -1;
@@ -2688,7 +2757,7 @@ bool Datetime::initializeEony (Pig& pig)
       t->tm_mday = 1;
       t->tm_year += 2;
       t->tm_isdst = -1;
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2718,15 +2787,16 @@ bool Datetime::initializeEaster (Pig& pig)
        ! unicodeLatinDigit (pig.peek ()))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       easter (t);
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
 
       // If the result is earlier this year, then recalc for next year.
       if (_date < now)
       {
-        t = localtime (&now);
+        t = localTime (now, now_tm, _context.timezone);
         t->tm_year++;
         easter (t);
       }
@@ -2734,7 +2804,7 @@ bool Datetime::initializeEaster (Pig& pig)
       // Adjust according to holiday-specific offsets.
       t->tm_mday += offsets[holiday];
 
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2756,19 +2826,20 @@ bool Datetime::initializeMidsommar (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
       midsommar (t);
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
 
       // If the result is earlier this year, then recalc for next year.
       if (_date < now)
       {
-        t = localtime (&now);
+        t = localTime (now, now_tm, _context.timezone);
         t->tm_year++;
         midsommar (t);
       }
 
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2792,19 +2863,20 @@ bool Datetime::initializeMidsommarafton (Pig& pig)
         ! unicodeLatinDigit (following))
     {
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
       midsommarafton (t);
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
 
       // If the result is earlier this year, then recalc for next year.
       if (_date < now)
       {
-        t = localtime (&now);
+        t = localTime (now, now_tm, _context.timezone);
         t->tm_year++;
         midsommarafton (t);
       }
 
-      _date = mktime (t);
+      _date = fromLocal (t, _context.timezone);
       return true;
     }
   }
@@ -2896,12 +2968,13 @@ bool Datetime::initializeInformalTime (Pig& pig)
     {
       // Midnight today + hours:minutes:seconds.
       time_t now = time (nullptr);
-      struct tm* t = localtime (&now);
+      struct tm now_tm;
+      struct tm* t = localTime (now, now_tm, _context.timezone);
 
       int now_seconds  = (t->tm_hour * 3600) + (t->tm_min * 60) + t->tm_sec;
       int calc_seconds = (hours      * 3600) + (minutes   * 60) + seconds;
 
-      if (Datetime::timeRelative &&
+      if (_context.timeRelative &&
           calc_seconds < now_seconds)
         ++t->tm_mday;
 
@@ -2914,7 +2987,7 @@ bool Datetime::initializeInformalTime (Pig& pig)
         t->tm_min = minutes;
         t->tm_sec = seconds;
         t->tm_isdst = -1;
-        _date = mktime (t);
+        _date = fromLocal (t, _context.timezone);
 
         return true;
       }
@@ -2960,9 +3033,7 @@ void Datetime::midsommar (struct tm* t) const
   t->tm_hour = t->tm_min = t->tm_sec = 0; // Midnight.
   t->tm_isdst = -1;                       // Probably DST, but check.
 
-  time_t then = mktime (t);               // Obtain the weekday of June 20th.
-  struct tm* mid = localtime (&then);
-  t->tm_mday += 6 - mid->tm_wday;         // How many days after 20th.
+  t->tm_mday += 6 - dayOfWeek (t->tm_year + 1900, 6, 20); // How many days after 20th.
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2973,9 +3044,7 @@ void Datetime::midsommarafton (struct tm* t) const
   t->tm_hour = t->tm_min = t->tm_sec = 0; // Midnight.
   t->tm_isdst = -1;                       // Probably DST, but check.
 
-  time_t then = mktime (t);               // Obtain the weekday of June 19th.
-  struct tm* mid = localtime (&then);
-  t->tm_mday += 5 - mid->tm_wday;         // How many days after 19th.
+  t->tm_mday += 5 - dayOfWeek (t->tm_year + 1900, 6, 19); // How many days after 19th.
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3047,13 +3116,13 @@ bool Datetime::initializeNthDayInMonth (const std::vector <std::string>& tokens)
     int ordinal {0};
     if (isOrdinal (tokens[0], ordinal))
     {
-      auto day = Datetime::dayOfWeek (tokens[1]);
+      auto day = Datetime::dayOfWeek (tokens[1], _context.minimumMatchLength);
       if (day != -1)
       {
         if (tokens[2] == "in" ||
             tokens[2] == "of")
         {
-          auto month = Datetime::monthOfYear (tokens[3]);
+          auto month = Datetime::monthOfYear (tokens[3], _context.minimumMatchLength);
           if (month != -1)
           {
             std::cout << "# ordinal=" << ordinal << " day=" << day << " in month=" << month << '\n';
@@ -3077,7 +3146,7 @@ bool Datetime::initializeNthDayInMonth (const std::vector <std::string>& tokens)
 ////////////////////////////////////////////////////////////////////////////////
 bool Datetime::isOrdinal (const std::string& token, int& ordinal)
 {
-  Pig p (token);
+  Pig p {std::string_view (token)};
   long long number;
   std::string suffix;
   if (p.getDigits (number) &&
@@ -3102,8 +3171,8 @@ bool Datetime::isOrdinal (const std::string& token, int& ordinal)
 bool Datetime::validate ()
 {
   // for ISO 8601 week specification: YYYY-Www-D where D is 1-7 (Mon-Sun)
-  int wks = (Datetime::weekstart == 1 ? 1: 0);
-  int wke = (Datetime::weekstart == 1 ? 7: 6);
+  int wks = (_context.weekstart == 1 ? 1: 0);
+  int wke = (_context.weekstart == 1 ? 7: 6);
 
   // _year;
   if ((_year    && (_year    <   1900 || _year    >                                  9999)) ||
@@ -3119,34 +3188,6 @@ bool Datetime::validate ()
   return true;
 }
 
-#ifndef HAVE_TIMEGM
-time_t Datetime::timegm(struct tm* tm) {
-  time_t ret;
-  char* tz;
-  tz = getenv("TZ");
-#ifdef _WIN32
-  _putenv_s("TZ", "UTC");
-  _tzset();
-  ret = mktime(tm);
-  if (tz)
-    _putenv_s("TZ", tz);
-  else
-    _putenv_s("TZ", "");
-  _tzset();
-#else
-  setenv("TZ", "UTC", 1);
-  tzset();
-  ret = mktime(tm);
-  if (tz)
-    setenv("TZ", tz, 1);
-  else
-    unsetenv("TZ");
-  tzset();
-#endif
-  return ret;
-}
-#endif
-
 ////////////////////////////////////////////////////////////////////////////////
 // int tm_sec;       seconds (0 - 60)
 // int tm_min;       minutes (0 - 59)
@@ -3185,7 +3226,8 @@ void Datetime::resolve ()
   }
 
   // Get 'now' in the relevant location.
-  struct tm* t_now = utc ? gmtime (&now) : localtime (&now);
+  struct tm now_tm;
+  struct tm* t_now = utc ? utcTime (now, now_tm) : localTime (now, now_tm, _context.timezone);
 
   int seconds_now = (t_now->tm_hour * 3600) +
                     (t_now->tm_min  *   60) +
@@ -3193,12 +3235,12 @@ void Datetime::resolve ()
 
   // Project forward one day if the specified seconds are earlier in the day
   // than the current seconds. Overridden by the ::timeRelative setting.
-  if (Datetime::timeRelative &&
+  if (_context.timeRelative &&
       year    == 0           &&
       month   == 0           &&
       day     == 0           &&
       week    == 0           &&
-      weekday == Datetime::weekstart &&
+      weekday == _context.weekstart &&
       seconds < seconds_now)
   {
     seconds += 86400;
@@ -3209,7 +3251,7 @@ void Datetime::resolve ()
   // as per ISO week spec.  This is incompatible with tm.tm_wday (which is
   // 0-6, Sunday based), but that field is not assigned anywhere in this
   // function, and note that mktime() uses tm_wday only as an output field.
-  // We use Datetime::weekstart as a hint about whether the user is
+  // We use the weekstart setting as a hint about whether the user is
   // giving/wants ISO weeks, although the very use of 2024-W30 and 2024-W30-1
   // format is from ISO8601 in the first place.
   //
@@ -3222,7 +3264,7 @@ void Datetime::resolve ()
     int jan4dow0 = dayOfWeek (year, 1, 4);
     int jan4dow1 = (jan4dow0 == 0 ? 7 : jan4dow0);
 
-    if (Datetime::weekstart == 1)
+    if (_context.weekstart == 1)
     {
       // https://en.wikipedia.org/wiki/ISO_week_date
       julian = week * 7 + weekday - (jan4dow1 + 3);
@@ -3282,24 +3324,9 @@ void Datetime::resolve ()
     day = julian;
   }
 
-  struct tm t {};
-  t.tm_isdst = -1;  // Requests that mktime/gmtime determine summer time effect.
-  t.tm_year = year - 1900;
-  t.tm_mon = month - 1;
-  t.tm_mday = day;
-
-  if (seconds > 86400)
-  {
-    int days = seconds / 86400;
-    t.tm_mday += days;
-    seconds %= 86400;
-  }
-
-  t.tm_hour = seconds / 3600;
-  t.tm_min = (seconds % 3600) / 60;
-  t.tm_sec = seconds % 60;
-
-  _date = utc ? timegm (&t) : mktime (&t);
+  // Seconds may be negative, or more than a day, and carry over.
+  int64_t local = (daysFromCivil (year, month, 1) + day - 1) * 86400 + seconds;
+  _date = utc ? local : fromLocal (local, _context.timezone);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3318,41 +3345,42 @@ std::string Datetime::toEpochString () const
 // 19980119T070000Z =  YYYYMMDDThhmmssZ
 std::string Datetime::toISO () const
 {
-  struct tm* t = gmtime (&_date);
+  struct tm utc;
+  auto t = utcTime (_date, utc);
 
-  std::stringstream iso;
-  iso << std::setw (4) << std::setfill ('0') << t->tm_year + 1900
-      << std::setw (2) << std::setfill ('0') << t->tm_mon + 1
-      << std::setw (2) << std::setfill ('0') << t->tm_mday
-      << 'T'
-      << std::setw (2) << std::setfill ('0') << t->tm_hour
-      << std::setw (2) << std::setfill ('0') << t->tm_min
-      << std::setw (2) << std::setfill ('0') << t->tm_sec
-      << 'Z';
+  char iso[32];
+  auto out = yearDigits (iso, t->tm_year + 1900);
+  out = digits (out, t->tm_mon + 1, 2);
+  out = digits (out, t->tm_mday, 2);
+  *out++ = 'T';
+  out = digits (out, t->tm_hour, 2);
+  out = digits (out, t->tm_min, 2);
+  out = digits (out, t->tm_sec, 2);
+  *out++ = 'Z';
 
-  return iso.str ();
+  return std::string (iso, out - iso);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // 1998-01-19T07:00:00 =  YYYY-MM-DDThh:mm:ss
 std::string Datetime::toISOLocalExtended () const
 {
-  struct tm* t = localtime (&_date);
+  auto t = local ();
 
-  std::stringstream iso;
-  iso << std::setw (4) << std::setfill ('0') << t->tm_year + 1900
-      << '-'
-      << std::setw (2) << std::setfill ('0') << t->tm_mon + 1
-      << '-'
-      << std::setw (2) << std::setfill ('0') << t->tm_mday
-      << 'T'
-      << std::setw (2) << std::setfill ('0') << t->tm_hour
-      << ':'
-      << std::setw (2) << std::setfill ('0') << t->tm_min
-      << ':'
-      << std::setw (2) << std::setfill ('0') << t->tm_sec;
+  char iso[32];
+  auto out = yearDigits (iso, t.tm_year + 1900);
+  *out++ = '-';
+  out = digits (out, t.tm_mon + 1, 2);
+  *out++ = '-';
+  out = digits (out, t.tm_mday, 2);
+  *out++ = 'T';
+  out = digits (out, t.tm_hour, 2);
+  *out++ = ':';
+  out = digits (out, t.tm_min, 2);
+  *out++ = ':';
+  out = digits (out, t.tm_sec, 2);
 
-  return iso.str ();
+  return std::string (iso, out - iso);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3364,82 +3392,65 @@ double Datetime::toJulian () const
 ////////////////////////////////////////////////////////////////////////////////
 void Datetime::toYMD (int& y, int& m, int& d) const
 {
-  struct tm* t = localtime (&_date);
+  auto t = local ();
 
-  m = t->tm_mon + 1;
-  d = t->tm_mday;
-  y = t->tm_year + 1900;
+  m = t.tm_mon + 1;
+  d = t.tm_mday;
+  y = t.tm_year + 1900;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string Datetime::toString (const std::string& format) const
 {
-  std::stringstream formatted;
-  for (unsigned int i = 0; i < format.length (); ++i)
-  {
-    int c = format[i];
-    switch (c)
-    {
-    case 'm': formatted                                        << month ();               break;
-    case 'M': formatted << std::setw (2) << std::setfill ('0') << month ();               break;
-    case 'd': formatted                                        << day ();                 break;
-    case 'D': formatted << std::setw (2) << std::setfill ('0') << day ();                 break;
-    case 'y': formatted << std::setw (2) << std::setfill ('0') << (year () % 100);        break;
-    case 'Y': formatted                                        << year ();                break;
-    case 'a': formatted                                        << Datetime::dayNameShort (dayOfWeek ()); break;
-    case 'A': formatted                                        << Datetime::dayName (dayOfWeek ());      break;
-    case 'b': formatted                                        << Datetime::monthNameShort (month ());   break;
-    case 'B': formatted                                        << Datetime::monthName (month ());        break;
-    case 'v': formatted                                        << week ();                break;
-    case 'V': formatted << std::setw (2) << std::setfill ('0') << week ();                break;
-    case 'h': formatted                                        << hour ();                break;
-    case 'H': formatted << std::setw (2) << std::setfill ('0') << hour ();                break;
-    case 'n': formatted                                        << minute ();              break;
-    case 'N': formatted << std::setw (2) << std::setfill ('0') << minute ();              break;
-    case 's': formatted                                        << second ();              break;
-    case 'S': formatted << std::setw (2) << std::setfill ('0') << second ();              break;
-    case 'j': formatted                                        << dayOfYear ();           break;
-    case 'J': formatted << std::setw (3) << std::setfill ('0') << dayOfYear ();           break;
-    case 'w': formatted                                        << dayOfWeek ();           break;
-    default:  formatted                                        << static_cast <char> (c); break;
-    }
-  }
+  return compiled (format).render (*this);
+}
 
-  return formatted.str ();
+////////////////////////////////////////////////////////////////////////////////
+std::string Datetime::toString (const DatetimeFormat& format) const
+{
+  return format.render (*this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// The start of each period is local midnight in this Datetime's zone.
 Datetime Datetime::startOfDay () const
 {
-  return { year (), month (), day () };
+  return at (fromLocal (daysFromCivil (year (), month (), day ()) * 86400, _context.timezone));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 Datetime Datetime::startOfWeek () const
 {
-  Datetime sow (_date);
-  sow -= (dayOfWeek () * 86400);
-  return { sow.year (), sow.month (), sow.day () };
+  return at (fromLocal ((daysFromCivil (year (), month (), day ()) - dayOfWeek ()) * 86400, _context.timezone));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 Datetime Datetime::startOfMonth () const
 {
-  return { year (), month (), 1 };
+  return at (fromLocal (daysFromCivil (year (), month (), 1) * 86400, _context.timezone));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 Datetime Datetime::startOfYear () const
 {
-  return { year (), 1, 1 };
+  return at (fromLocal (daysFromCivil (year (), 1, 1) * 86400, _context.timezone));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool Datetime::valid (const std::string& input, const std::string& format)
+{
+  return valid (input, format, Context ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Datetime::valid (
+  const std::string& input,
+  const std::string& format,
+  const Context& context)
 {
   try
   {
-    Datetime test (input, format);
+    Datetime test (input, format, context);
   }
 
   catch (...)
@@ -3450,6 +3461,162 @@ bool Datetime::valid (const std::string& input, const std::string& format)
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Parses each input as Datetime (input, format, context) would, into times,
+// and marks those that are not dates in failed, leaving their time zero.
+// Returns the number that failed.
+std::size_t Datetime::parseColumn (
+  const std::vector <std::string>& inputs,
+  std::vector <time_t>& times,
+  std::vector <bool>& failed,
+  const std::string& format,
+  const Context& context,
+  unsigned int threads)
+{
+  return column (inputs, times, failed, format, context, threads);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t Datetime::parseColumn (
+  const std::vector <std::string_view>& inputs,
+  std::vector <time_t>& times,
+  std::vector <bool>& failed,
+  const std::string& format,
+  const Context& context,
+  unsigned int threads)
+{
+  return column (inputs, times, failed, format, context, threads);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A column is usually all in one form.  When the first date in it is in one
+// of the fixed-width forms, and there is no format, that form is read first
+// for the rest, and the grammar only for those not in it.  Nothing ahead of
+// the grammar's own reading of either form can match it, so the results are
+// the grammar's.
+//
+// With threads other than one, or zero for one per core, the rest is split
+// between that many threads.
+template <typename T>
+std::size_t Datetime::column (
+  const std::vector <T>& inputs,
+  std::vector <time_t>& times,
+  std::vector <bool>& failed,
+  const std::string& format,
+  const Context& context,
+  unsigned int threads)
+{
+  enum class form {grammar, compact, extended};
+
+  times.assign (inputs.size (), 0);
+  failed.assign (inputs.size (), false);
+
+  DatetimeFormat plan (format);
+
+  // Parses inputs from begin to end, and lists those that fail.
+  auto run = [&] (std::size_t begin, std::size_t end, form first, std::vector <std::size_t>& failures)
+  {
+    Datetime date (context);
+    for (auto i = begin; i < end; ++i)
+    {
+      std::string_view text (inputs[i]);
+      if ((first == form::compact  && date.parse_compact_utc (text)) ||
+          (first == form::extended && date.parse_extended (text)))
+      {
+        times[i] = date._date;
+        continue;
+      }
+
+      date.clear ();
+      std::string::size_type start = 0;
+      if (date.parse_text (text, start, plan, context))
+        times[i] = date._date;
+      else
+        failures.push_back (i);
+    }
+  };
+
+  // The form of the first date that parses is the one to favour.
+  std::vector <std::vector <std::size_t>> failures (1);
+  std::size_t next = 0;
+  auto first = form::grammar;
+  while (next < inputs.size () && failures[0].size () == next)
+  {
+    run (next, next + 1, form::grammar, failures[0]);
+    if (failures[0].size () == next && plan.empty ())
+    {
+      Datetime probe (context);
+      std::string_view text (inputs[next]);
+           if (probe.parse_compact_utc (text)) first = form::compact;
+      else if (probe.parse_extended (text))    first = form::extended;
+    }
+
+    ++next;
+  }
+
+  if (threads == 0)
+    threads = std::max (1u, std::thread::hardware_concurrency ());
+
+  auto remaining = inputs.size () - next;
+  auto runs = std::max ((std::size_t) 1, std::min ((std::size_t) threads, remaining / minimumRun));
+  auto size = remaining / runs;
+  failures.resize (runs + 1);
+
+  // An exception escaping a thread would terminate the program, so the first
+  // is kept and rethrown here once every thread has been joined.
+  std::exception_ptr error;
+  std::mutex errorLock;
+  auto share = [&] (std::size_t i)
+  {
+    try
+    {
+      run (next + i * size, i + 1 == runs ? inputs.size () : next + (i + 1) * size, first, failures[i + 1]);
+    }
+
+    catch (...)
+    {
+      std::lock_guard <std::mutex> lock (errorLock);
+      if (! error)
+        error = std::current_exception ();
+    }
+  };
+
+  // A share whose thread cannot be started is run here instead.
+  std::vector <std::thread> pool;
+  pool.reserve (runs);
+  std::size_t started = 1;
+  try
+  {
+    for (; started < runs; ++started)
+      pool.emplace_back (share, started);
+  }
+
+  catch (const std::system_error&)
+  {
+  }
+
+  share (0);
+  for (auto i = started; i < runs; ++i)
+    share (i);
+
+  for (auto& thread : pool)
+    thread.join ();
+
+  if (error)
+    std::rethrow_exception (error);
+
+  std::size_t count = 0;
+  for (auto& list : failures)
+  {
+    for (auto i : list)
+      failed[i] = true;
+
+    count += list.size ();
+  }
+
+  return count;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool Datetime::valid (
   const int y, const int m, const int d,
@@ -3536,6 +3703,35 @@ int Datetime::daysInYear (int year)
   return Datetime::leapYear (year) ? 366 : 365;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Static.  Days since 1970-01-01 in the proleptic Gregorian calendar, from
+// http://howardhinnant.github.io/date_algorithms.html.  The day may be out of
+// range for the month, and carries over.
+int64_t Datetime::daysFromCivil (int year, int month, int day)
+{
+  int64_t y   = year - (month <= 2);
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  int64_t yoe = y - era * 400;                                   // [0, 399]
+  int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;           // [0, 146096]
+  return era * 146097 + doe - 719468;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static.  The inverse of daysFromCivil.
+void Datetime::civilFromDays (int64_t days, int& year, int& month, int& day)
+{
+  days += 719468;
+  int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  int64_t doe = days - era * 146097;                             // [0, 146096]
+  int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);         // [0, 365]
+  int64_t mp  = (5 * doy + 2) / 153;                             // [0, 11]
+  day   = doy - (153 * mp + 2) / 5 + 1;
+  month = mp < 10 ? mp + 3 : mp - 9;
+  year  = yoe + era * 400 + (month <= 2);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Static
 std::string Datetime::monthName (int month)
@@ -3576,11 +3772,18 @@ std::string Datetime::dayNameShort (int dow)
 // Static
 int Datetime::dayOfWeek (const std::string& input)
 {
-  if (Datetime::minimumMatchLength== 0)
-    Datetime::minimumMatchLength = 3;
+  return Datetime::dayOfWeek (input, Datetime::minimumMatchLength);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static.  A minimum of zero means the default of three.
+int Datetime::dayOfWeek (const std::string& input, int minimum)
+{
+  if (minimum == 0)
+    minimum = 3;
 
   for (unsigned int i = 0; i < dayNames.size (); ++i)
-    if (closeEnough (dayNames[i], input, Datetime::minimumMatchLength))
+    if (closeEnough (dayNames[i], input, minimum))
        return i;
 
   return -1;
@@ -3613,11 +3816,18 @@ int Datetime::dayOfWeek (int year, int month, int day)
 // Static
 int Datetime::monthOfYear (const std::string& input)
 {
-  if (Datetime::minimumMatchLength== 0)
-    Datetime::minimumMatchLength = 3;
+  return Datetime::monthOfYear (input, Datetime::minimumMatchLength);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Static.  A minimum of zero means the default of three.
+int Datetime::monthOfYear (const std::string& input, int minimum)
+{
+  if (minimum == 0)
+    minimum = 3;
 
   for (unsigned int i = 0; i < monthNames.size (); ++i)
-    if (closeEnough (monthNames[i], input, Datetime::minimumMatchLength))
+    if (closeEnough (monthNames[i], input, minimum))
        return i + 1;
 
   return -1;
@@ -3661,23 +3871,33 @@ int Datetime::length (const std::string& format)
   return len;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// The accessors all read the local broken-down time of _date, in the zone of
+// the Context.  It is converted on each call, so that a const Datetime is not
+// written to and may be read from several threads.
+struct tm Datetime::local () const
+{
+  struct tm t;
+  localTime (_date, t, _context.timezone);
+  return t;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int Datetime::month () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_mon + 1;
+  return local ().tm_mon + 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int Datetime::week () const
 {
-  struct tm* t = localtime (&_date);
+  auto t = local ();
 
   char weekStr[3];
-  if (Datetime::weekstart == 0)
-    strftime (weekStr, sizeof (weekStr), "%U", t);
-  else if (Datetime::weekstart == 1)
-    strftime (weekStr, sizeof (weekStr), "%V", t);
+  if (_context.weekstart == 0)
+    strftime (weekStr, sizeof (weekStr), "%U", &t);
+  else if (_context.weekstart == 1)
+    strftime (weekStr, sizeof (weekStr), "%V", &t);
   else
     throw std::string ("The week may only start on a Sunday or Monday.");
 
@@ -3689,50 +3909,43 @@ int Datetime::week () const
 ////////////////////////////////////////////////////////////////////////////////
 int Datetime::day () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_mday;
+  return local ().tm_mday;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int Datetime::year () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_year + 1900;
+  return local ().tm_year + 1900;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int Datetime::dayOfWeek () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_wday;
+  return local ().tm_wday;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int Datetime::dayOfYear () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_yday + 1;
+  return local ().tm_yday + 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int Datetime::hour () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_hour;
+  return local ().tm_hour;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int Datetime::minute () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_min;
+  return local ().tm_min;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int Datetime::second () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_sec;
+  return local ().tm_sec;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3818,13 +4031,13 @@ bool Datetime::sameYear (const Datetime& rhs) const
 ////////////////////////////////////////////////////////////////////////////////
 Datetime Datetime::operator+ (const int64_t delta)
 {
-  return { _date + delta };
+  return at (_date + delta);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 Datetime Datetime::operator- (const int64_t delta)
 {
-  return { _date - delta };
+  return at (_date - delta);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
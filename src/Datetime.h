@@ -31,12 +31,17 @@
 #include <ctime>
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "cmake.h"
 
 #define EPOCH_MIN_VALUE 315532800    // 1980-01-01T00:00:00Z
 #define EPOCH_MAX_VALUE 253402293599 // 9999-12-31, 23:59:59 AoE
 
+class DatetimeFormat;
+class Timezone;
+
 class Datetime
 {
 public:
@@ -47,12 +52,37 @@ public:
   static bool standaloneTimeEnabled;
   static bool timeRelative;
 
+  // The settings that parsing and formatting depend on.  A Context starts
+  // as a copy of the statics above, and a Datetime keeps its own copy, so
+  // threads may parse with their own settings, or share one Context, without
+  // touching the statics.
+  struct Context
+  {
+    Context ();
+
+    int  weekstart;
+    int  minimumMatchLength;
+    bool isoEnabled;
+    bool standaloneDateEnabled;
+    bool standaloneTimeEnabled;
+    bool timeRelative;
+
+    // Local times are in this zone, or when null, in the zone libc uses.
+    const Timezone* timezone;
+  };
+
   Datetime ();
+  Datetime (const Context&);
   Datetime (const std::string&, const std::string& format = "");
+  Datetime (const std::string&, const std::string&, const Context&);
+  Datetime (const std::string&, const DatetimeFormat&, const Context&);
   Datetime (time_t);
   Datetime (const int, const int, const int);
   Datetime (const int, const int, const int, const int, const int, const int);
   bool parse (const std::string&, std::string::size_type&, const std::string& format = "");
+  bool parse (const std::string&, std::string::size_type&, const std::string&, const Context&);
+  bool parse (const std::string&, std::string::size_type&, const DatetimeFormat&, const Context&);
+  const Context& context () const;
   time_t toEpoch () const;
   std::string toEpochString () const;
   std::string toISO () const;
@@ -60,6 +90,7 @@ public:
   double toJulian () const;
   void toYMD (int&, int&, int&) const;
   std::string toString (const std::string& format = "Y-M-D") const;
+  std::string toString (const DatetimeFormat&) const;
 
   Datetime startOfDay () const;
   Datetime startOfWeek () const;
@@ -67,19 +98,26 @@ public:
   Datetime startOfYear () const;
 
   static bool valid (const std::string&, const std::string& format = "");
+  static bool valid (const std::string&, const std::string&, const Context&);
+  static std::size_t parseColumn (const std::vector <std::string>&, std::vector <time_t>&, std::vector <bool>&, const std::string& format = "", const Context& context = Context (), unsigned int threads = 1);
+  static std::size_t parseColumn (const std::vector <std::string_view>&, std::vector <time_t>&, std::vector <bool>&, const std::string& format = "", const Context& context = Context (), unsigned int threads = 1);
   static bool valid (const int, const int, const int, const int, const int, const int);
   static bool valid (const int, const int, const int);
   static bool valid (const int, const int);
   static bool leapYear (int);
   static int daysInMonth (int, int);
   static int daysInYear (int);
+  static int64_t daysFromCivil (int, int, int);
+  static void civilFromDays (int64_t, int&, int&, int&);
   static std::string monthName (int);
   static std::string monthNameShort (int);
   static std::string dayName (int);
   static std::string dayNameShort (int);
   static int dayOfWeek (const std::string&);
+  static int dayOfWeek (const std::string&, int);
   static int dayOfWeek (int, int, int);
   static int monthOfYear (const std::string&);
+  static int monthOfYear (const std::string&, int);
   static int length (const std::string&);
 
   int month () const;
@@ -115,10 +153,15 @@ public:
   void operator++  (int); // Postfix
 
 private:
+  friend class DatetimeFormat;
+
   void clear ();
-  bool parse_formatted     (Pig&, const std::string&);
+  Datetime at              (time_t) const;
+  bool parse_text          (std::string_view, std::string::size_type&, const DatetimeFormat&, const Context&);
   bool parse_named         (Pig&);
   bool parse_epoch         (Pig&);
+  bool parse_compact_utc   (std::string_view);
+  bool parse_extended      (std::string_view);
   bool parse_date_time_ext (Pig&);
   bool parse_date_ext      (Pig&);
   bool parse_off_ext       (Pig&);
@@ -203,9 +246,12 @@ private:
   bool validate ();
   void resolve ();
 
-  #ifndef HAVE_TIMEGM
-  time_t timegm(struct tm*);
-  #endif
+  template <typename T>
+  static std::size_t column (const std::vector <T>&, std::vector <time_t>&, std::vector <bool>&, const std::string&, const Context&, unsigned int);
+
+  struct tm local () const;
+
+  Context _context;
 
 public:
   int _year    {0};
@@ -0,0 +1,508 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <DatetimeFormat.h>
+#include <Datetime.h>
+#include <charconv>
+#include <cstring>
+#include <unicode.h>
+
+// As Datetime::dayName and Datetime::monthName give them, without building a
+// string for each date.
+static const char* days[] = {
+  "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+
+static const char* months[] = {
+  "January", "February", "March", "April", "May", "June", "July", "August",
+  "September", "October", "November", "December"};
+
+// The longest field is an int, with its sign.
+static const std::size_t longestField = 11;
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes value, padded with zeroes to width, as a stream with setw and
+// setfill ('0') would.
+static char* number (char* out, int value, int width)
+{
+  char digits[longestField];
+  auto length = std::to_chars (digits, digits + sizeof (digits), value).ptr - digits;
+  for (; length < width; --width)
+    *out++ = '0';
+
+  std::memcpy (out, digits, length);
+  return out + length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static char* text (char* out, const char* name, std::size_t length)
+{
+  std::memcpy (out, name, length);
+  return out + length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Every letter that is a field when rendering.  Parsing has no fields for 'j',
+// 'J' and 'w', and matches them literally.
+DatetimeFormat::DatetimeFormat (const std::string& format)
+: _format (format)
+{
+  for (std::size_t i = 0; i < _format.length (); ++i)
+  {
+    auto c = _format[i];
+    switch (c)
+    {
+    case 'm': case 'M': case 'd': case 'D': case 'y': case 'Y':
+    case 'a': case 'A': case 'b': case 'B': case 'v': case 'V':
+    case 'h': case 'H': case 'n': case 'N': case 's': case 'S':
+    case 'j': case 'J': case 'w':
+      _ops.push_back ({c, i, 1});
+      _capacity += longestField;
+      break;
+
+    default:
+      if (! _ops.empty () && _ops.back ().code == 0)
+        ++_ops.back ().length;
+      else
+        _ops.push_back ({0, i, 1});
+
+      ++_capacity;
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& DatetimeFormat::str () const
+{
+  return _format;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DatetimeFormat::empty () const
+{
+  return _ops.empty ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The size of buffer that render (const Datetime&, char*) needs.
+std::size_t DatetimeFormat::capacity () const
+{
+  return _capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string DatetimeFormat::render (const Datetime& date) const
+{
+  std::string output;
+  render (date, output);
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Appends to output, so that a column of dates is rendered into one string.
+void DatetimeFormat::render (const Datetime& date, std::string& output) const
+{
+  auto size = output.size ();
+  output.resize (size + _capacity);
+  output.resize (size + render (date, &output[size]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes no more than capacity () characters, without a terminating null, and
+// returns the number written.
+std::size_t DatetimeFormat::render (const Datetime& date, char* buffer) const
+{
+  auto t = date.local ();
+  auto out = buffer;
+  for (auto& op : _ops)
+  {
+    switch (op.code)
+    {
+    case 0:   out = text   (out, _format.data () + op.offset, op.length);             break;
+    case 'm': out = number (out, t.tm_mon + 1, 0);                                     break;
+    case 'M': out = number (out, t.tm_mon + 1, 2);                                     break;
+    case 'd': out = number (out, t.tm_mday, 0);                                        break;
+    case 'D': out = number (out, t.tm_mday, 2);                                        break;
+    case 'y': out = number (out, (t.tm_year + 1900) % 100, 2);                         break;
+    case 'Y': out = number (out, t.tm_year + 1900, 0);                                 break;
+    case 'a': out = text   (out, days[t.tm_wday], 3);                                  break;
+    case 'A': out = text   (out, days[t.tm_wday], std::strlen (days[t.tm_wday]));      break;
+    case 'b': out = text   (out, months[t.tm_mon], 3);                                 break;
+    case 'B': out = text   (out, months[t.tm_mon], std::strlen (months[t.tm_mon]));    break;
+    case 'v': out = number (out, date.week (), 0);                                     break;
+    case 'V': out = number (out, date.week (), 2);                                     break;
+    case 'h': out = number (out, t.tm_hour, 0);                                        break;
+    case 'H': out = number (out, t.tm_hour, 2);                                        break;
+    case 'n': out = number (out, t.tm_min, 0);                                         break;
+    case 'N': out = number (out, t.tm_min, 2);                                         break;
+    case 's': out = number (out, t.tm_sec, 0);                                         break;
+    case 'S': out = number (out, t.tm_sec, 2);                                         break;
+    case 'j': out = number (out, t.tm_yday + 1, 0);                                    break;
+    case 'J': out = number (out, t.tm_yday + 1, 3);                                    break;
+    case 'w': out = number (out, t.tm_wday, 0);                                        break;
+    }
+  }
+
+  return out - buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sets the year, month, day and seconds of date, which Datetime::parse then
+// validates and resolves.
+bool DatetimeFormat::parse (Pig& pig, Datetime& date) const
+{
+  // Short-circuit on missing format.
+  if (_ops.empty ())
+    return false;
+
+  auto checkpoint = pig.cursor ();
+
+  int month  {-1};   // So we can check later.
+  int day    {-1};
+  int year   {-1};
+  int hour   {-1};
+  int minute {-1};
+  int second {-1};
+
+  // For parsing, unused.
+  int wday   {-1};
+  int week   {-1};
+
+  // Day and month names run up to the character that follows them in the
+  // format.
+  auto stop = [this] (const op& field)
+  {
+    return field.offset + 1 < _format.length () ? _format[field.offset + 1] : '\0';
+  };
+
+  for (auto& op : _ops)
+  {
+    switch (op.code)
+    {
+    case 0:
+      for (std::size_t i = op.offset; i < op.offset + op.length; ++i)
+      {
+        if (! pig.skip (_format[i]))
+        {
+          pig.restoreTo (checkpoint);
+          return false;
+        }
+      }
+      break;
+
+    case 'm':
+      if (pig.getDigit (month))
+      {
+        if (month == 0)
+          pig.getDigit (month);
+
+        if (month == 1)
+          if (pig.getDigit (month))
+            month += 10;
+      }
+      else
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'M':
+      if (! pig.getDigit2 (month))
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'd':
+      if (pig.getDigit (day))
+      {
+        if (day == 0)
+          pig.getDigit (day);
+
+        if (day == 1 || day == 2 || day == 3)
+        {
+          int tens = day;
+          if (pig.getDigit (day))
+            day += 10 * tens;
+        }
+      }
+      else
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'D':
+      if (! pig.getDigit2 (day))
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'y':
+      if (! pig.getDigit2 (year))
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      year += 2000;
+      break;
+
+    case 'Y':
+      if (! pig.getDigit4 (year))
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'h':
+      if (pig.getDigit (hour))
+      {
+        if (hour == 0)
+          pig.getDigit (hour);
+
+        if (hour == 1 || hour == 2)
+        {
+          int tens = hour;
+          if (pig.getDigit (hour))
+            hour += 10 * tens;
+        }
+      }
+      else
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'H':
+      if (! pig.getDigit2 (hour))
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'n':
+      if (pig.getDigit (minute))
+      {
+        if (minute == 0)
+          pig.getDigit (minute);
+
+        if (minute < 6)
+        {
+          int tens = minute;
+          if (pig.getDigit (minute))
+            minute += 10 * tens;
+        }
+      }
+      else
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'N':
+      if (! pig.getDigit2 (minute))
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 's':
+      if (pig.getDigit (second))
+      {
+        if (second == 0)
+          pig.getDigit (second);
+
+        if (second < 6)
+        {
+          int tens = second;
+          if (pig.getDigit (second))
+            second += 10 * tens;
+        }
+      }
+      else
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'S':
+      if (! pig.getDigit2 (second))
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'v':
+      if (pig.getDigit (week))
+      {
+        if (week == 0)
+          pig.getDigit (week);
+
+        if (week < 6)
+        {
+          int tens = week;
+          if (pig.getDigit (week))
+            week += 10 * tens;
+        }
+      }
+      else
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'V':
+      if (! pig.getDigit2 (week))
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+
+    case 'a':
+      wday = Datetime::dayOfWeek (pig.peek (3), date._context.minimumMatchLength);
+      if (wday == -1)
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+
+      pig.skipN (3);
+      break;
+
+    case 'A':
+      {
+        std::string dayName;
+        if (pig.getUntil (stop (op), dayName))
+        {
+          wday = Datetime::dayOfWeek (dayName, date._context.minimumMatchLength);
+          if (wday == -1)
+          {
+            pig.restoreTo (checkpoint);
+            return false;
+          }
+        }
+      }
+      break;
+
+    case 'b':
+      month = Datetime::monthOfYear (pig.peek (3), date._context.minimumMatchLength);
+      if (month == -1)
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+
+      pig.skipN (3);
+      break;
+
+    case 'B':
+      {
+        std::string monthName;
+        if (pig.getUntil (stop (op), monthName))
+        {
+          month = Datetime::monthOfYear (monthName, date._context.minimumMatchLength);
+          if (month == -1)
+          {
+            pig.restoreTo (checkpoint);
+            return false;
+          }
+        }
+      }
+      break;
+
+    default:
+      if (! pig.skip (op.code))
+      {
+        pig.restoreTo (checkpoint);
+        return false;
+      }
+      break;
+    }
+  }
+
+  // It is possible that the format='Y-M-D', and the input is Y-M-DTH:N:SZ, and
+  // this should not be considered a match.
+  if (! pig.eos () && ! unicodeWhitespace (pig.peek ()))
+  {
+    pig.restoreTo (checkpoint);
+    return false;
+  }
+
+  // Missing values are filled in from the current date.
+  if (year == -1)
+  {
+    Datetime now (date._context);
+    year = now.year ();
+    if (month == -1)
+    {
+      month = now.month ();
+      if (day == -1)
+      {
+        day = now.day ();
+        if (hour == -1)
+        {
+          hour = now.hour ();
+          if (minute == -1)
+          {
+            minute = now.minute ();
+            if (second == -1)
+              second = now.second ();
+          }
+        }
+      }
+    }
+  }
+
+  // Any remaining undefined values are assigned defaults.
+  if (month  == -1) month  = 1;
+  if (day    == -1) day    = 1;
+  if (hour   == -1) hour   = 0;
+  if (minute == -1) minute = 0;
+  if (second == -1) second = 0;
+
+  date._year    = year;
+  date._month   = month;
+  date._day     = day;
+  date._seconds = (hour * 3600) + (minute * 60) + second;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
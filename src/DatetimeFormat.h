@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_DATETIMEFORMAT
+#define INCLUDED_DATETIMEFORMAT
+
+#include <Pig.h>
+#include <string>
+#include <vector>
+
+class Datetime;
+
+// A Datetime format, such as "Y-M-DTH:N:S", compiled once into a list of
+// fields and literal runs, so that rendering and parsing many dates with the
+// same format does not re-read it for every date.
+class DatetimeFormat
+{
+public:
+  explicit DatetimeFormat (const std::string&);
+
+  const std::string& str () const;
+  bool empty () const;
+  std::size_t capacity () const;
+
+  std::string render (const Datetime&) const;
+  void render (const Datetime&, std::string&) const;
+  std::size_t render (const Datetime&, char*) const;
+
+private:
+  friend class Datetime;
+
+  // A field, named by its letter in the format, or when code is zero, a run
+  // of literal characters of the format.
+  struct op
+  {
+    char        code   {0};
+    std::size_t offset {0};
+    std::size_t length {0};
+  };
+
+  bool parse (Pig&, Datetime&) const;
+
+private:
+  std::string      _format   {};
+  std::vector <op> _ops      {};
+  std::size_t      _capacity {0};   // The longest rendering.
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
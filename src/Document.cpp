@@ -0,0 +1,463 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <JSON.h>
+#include <format.h>
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+// Parse-time stacks of the children of every array and object still open.
+// Each container collects its children at the top of these, then moves them
+// into the arena as one contiguous run once it is closed.
+struct json::document::scratch
+{
+  std::vector <element>          items;
+  std::vector <std::string_view> keys;
+};
+
+// Objects with more members than this find duplicate names with a hash set.
+static const std::size_t linearThreshold = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+// Removes, from the members of an object at the top of the scratch stacks,
+// those whose name appeared earlier.  Like json::object, the first wins.
+static void dropDuplicates (
+  std::vector <json::element>& items,
+  std::vector <std::string_view>& keys,
+  std::size_t base)
+{
+  auto count = items.size () - base;
+  auto first = keys.size () - count;
+  if (count < 2)
+    return;
+
+  std::unordered_set <std::string_view> seen;
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    auto name = keys[first + i];
+    auto duplicate = count <= linearThreshold
+                   ? std::find (keys.begin () + first, keys.begin () + first + kept, name) != keys.begin () + first + kept
+                   : ! seen.insert (name).second;
+    if (! duplicate)
+    {
+      keys[first + kept] = name;
+      items[base + kept] = items[base + i];
+      ++kept;
+    }
+  }
+
+  keys.resize (first + kept);
+  items.resize (base + kept);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* json::arena::allocate (std::size_t bytes, std::size_t align)
+{
+  auto padding = static_cast <std::size_t> (-reinterpret_cast <std::uintptr_t> (_next)) & (align - 1);
+  if (_next == nullptr || padding + bytes > _available)
+  {
+    // Oversized requests get a block of their own, so that the remainder of
+    // the current block is not wasted.
+    if (bytes + align > _size / 4)
+    {
+      _blocks.emplace_back (new char[bytes + align]);
+      auto base = reinterpret_cast <std::uintptr_t> (_blocks.back ().get ());
+      return reinterpret_cast <void*> ((base + align - 1) & ~(align - 1));
+    }
+
+    _size *= 2;
+    _blocks.emplace_back (new char[_size]);
+    _next      = _blocks.back ().get ();
+    _available = _size;
+    padding    = static_cast <std::size_t> (-reinterpret_cast <std::uintptr_t> (_next)) & (align - 1);
+  }
+
+  auto result = _next + padding;
+  _next      += padding + bytes;
+  _available -= padding + bytes;
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::jtype json::element::type () const
+{
+  return _type;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string json::element::dump () const
+{
+  std::string output;
+  dump (output);
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Appends to output, so that a whole tree is rendered into one string.
+void json::element::dump (std::string& output) const
+{
+  Writer writer (output);
+  write (writer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::element::write (Writer& writer) const
+{
+  switch (_type)
+  {
+  case j_string:
+    writer.encodedValue (_string);
+    break;
+
+  case j_number:
+         if (_kind == json::number::intvalue)  writer.value (_ivalue);
+    else if (_kind == json::number::uintvalue) writer.value (_uvalue);
+    else                                       writer.value (_number);
+    break;
+
+  case j_literal:
+    if (_lvalue == literal::nullvalue)
+      writer.null ();
+    else
+      writer.value (_lvalue != literal::falsevalue);
+    break;
+
+  case j_array:
+    writer.beginArray ();
+    for (std::size_t i = 0; i < _children.count; ++i)
+      _children.items[i].write (writer);
+
+    writer.endArray ();
+    break;
+
+  case j_object:
+    writer.beginObject ();
+    for (std::size_t i = 0; i < _children.count; ++i)
+    {
+      writer.encodedKey (_children.keys[i]);
+      _children.items[i].write (writer);
+    }
+
+    writer.endObject ();
+    break;
+
+  case j_value:
+    writer.raw ("<value>");
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string_view json::element::str () const
+{
+  return _type == j_string ? _string : std::string_view ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double json::element::number () const
+{
+  if (_type != j_number)
+    return 0.0;
+
+       if (_kind == json::number::intvalue)  return (double) _ivalue;
+  else if (_kind == json::number::uintvalue) return (double) _uvalue;
+  else                                       return _number;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::number::number_kind json::element::kind () const
+{
+  return _type == j_number ? _kind : json::number::realvalue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int64_t json::element::ivalue () const
+{
+  return kind () == json::number::intvalue ? _ivalue : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t json::element::uvalue () const
+{
+  return kind () == json::number::uintvalue ? _uvalue : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::literal::literal_value json::element::lvalue () const
+{
+  return _type == j_literal ? _lvalue : literal::none;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t json::element::size () const
+{
+  return _type == j_array || _type == j_object ? _children.count : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const json::element& json::element::operator[] (std::size_t index) const
+{
+  if (index >= size ())
+    throw format ("Error: element index {1} out of range", (int) index);
+
+  return _children.items[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string_view json::element::key (std::size_t index) const
+{
+  if (_type != j_object || index >= _children.count)
+    throw format ("Error: element index {1} out of range", (int) index);
+
+  return _children.keys[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Linear, which for the object sizes seen in practice beats any index.  Names
+// are unique, as duplicates are dropped when the object is parsed.
+const json::element* json::element::find (std::string_view name) const
+{
+  if (_type == j_object)
+    for (std::size_t i = 0; i < _children.count; ++i)
+      if (_children.keys[i] == name)
+        return &_children.items[i];
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accepts and rejects exactly what json::parse does, with the same errors.
+json::document::document (const std::string& input)
+{
+  scratch stacks;
+
+  Pig n {std::string_view (input)};
+  n.skipWS ();
+
+       if (n.peek () == '{') parse_object (n, _root, stacks);
+  else if (n.peek () == '[') parse_array  (n, _root, stacks);
+  else
+    throw format ("Error: expected '{' or '[' at position {1}", (int) n.cursor ());
+
+  // Check for end condition.
+  n.skipWS ();
+  if (!n.eos ())
+    throw format ("Error: extra characters found at position {1}", (int) n.cursor ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const json::element& json::document::root () const
+{
+  return _root;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string json::document::dump () const
+{
+  return _root.dump ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool json::document::parse_value (Pig& pig, element& result, scratch& stacks)
+{
+  if (parse_object (pig, result, stacks) ||
+      parse_array  (pig, result, stacks))
+    return true;
+
+  std::string_view content;
+  if (pig.getQuoted ('"', content))
+  {
+    result._type   = j_string;
+    result._string = store (content);
+    return true;
+  }
+
+  if (pig.getNumber (content))
+  {
+    json::number n;
+    json::number::convert (content, n);
+    result._type = j_number;
+    result._kind = n._kind;
+         if (n._kind == json::number::intvalue)  result._ivalue = n._ivalue;
+    else if (n._kind == json::number::uintvalue) result._uvalue = n._uvalue;
+    else                                         result._number = n._dvalue;
+    return true;
+  }
+
+       if (pig.skipLiteral ("null"))  result._lvalue = literal::nullvalue;
+  else if (pig.skipLiteral ("false")) result._lvalue = literal::falsevalue;
+  else if (pig.skipLiteral ("true"))  result._lvalue = literal::truevalue;
+  else
+    return false;
+
+  result._type = j_literal;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool json::document::parse_array (Pig& pig, element& result, scratch& stacks)
+{
+  auto checkpoint = pig.cursor ();
+
+  pig.skipWS ();
+  if (pig.skip ('['))
+  {
+    pig.skipWS ();
+
+    auto base = stacks.items.size ();
+    element value;
+    if (parse_value (pig, value, stacks))
+    {
+      stacks.items.push_back (value);
+      pig.skipWS ();
+      while (pig.skip (','))
+      {
+        pig.skipWS ();
+
+        if (parse_value (pig, value, stacks))
+        {
+          stacks.items.push_back (value);
+          pig.skipWS ();
+        }
+        else
+          throw format ("Error: missing value after ',' at position {1}", (int) pig.cursor ());
+      }
+    }
+
+    if (! pig.skip (']'))
+      throw format ("Error: missing ']' at position {1}", (int) pig.cursor ());
+
+    auto count = stacks.items.size () - base;
+    result._type     = j_array;
+    result._children = {store (stacks.items, base), nullptr, count};
+    return true;
+  }
+
+  pig.restoreTo (checkpoint);
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool json::document::parse_object (Pig& pig, element& result, scratch& stacks)
+{
+  auto checkpoint = pig.cursor ();
+
+  pig.skipWS ();
+  if (pig.skip ('{'))
+  {
+    pig.skipWS ();
+
+    auto base = stacks.items.size ();
+    if (parse_pair (pig, stacks))
+    {
+      pig.skipWS ();
+      while (pig.skip (','))
+      {
+        pig.skipWS ();
+
+        if (parse_pair (pig, stacks))
+          pig.skipWS ();
+        else
+          throw format ("Error: missing value after ',' at position {1}", (int) pig.cursor ());
+      }
+    }
+
+    if (! pig.skip ('}'))
+      throw format ("Error: missing '}' at position {1}", (int) pig.cursor ());
+
+    dropDuplicates (stacks.items, stacks.keys, base);
+    auto count = stacks.items.size () - base;
+    result._type     = j_object;
+    result._children = {store (stacks.items, base), store (stacks.keys, stacks.keys.size () - count), count};
+    return true;
+  }
+
+  pig.restoreTo (checkpoint);
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Pushes the name and value of one member onto the scratch stacks.
+bool json::document::parse_pair (Pig& pig, scratch& stacks)
+{
+  auto checkpoint = pig.cursor ();
+
+  std::string_view name;
+  if (pig.getQuoted ('"', name))
+  {
+    pig.skipWS ();
+    if (pig.skip (':'))
+    {
+      pig.skipWS ();
+      element value;
+      if (parse_value (pig, value, stacks))
+      {
+        stacks.keys.push_back (store (name));
+        stacks.items.push_back (value);
+        return true;
+      }
+      else
+        throw format ("Error: missing value at position {1}", (int) pig.cursor ());
+    }
+    else
+      throw format ("Error: missing ':' at position {1}", (int) pig.cursor ());
+  }
+
+  pig.restoreTo (checkpoint);
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Moves the top of a scratch stack, from base upwards, into the arena.
+template <typename T>
+T* json::document::store (std::vector <T>& stack, std::size_t base)
+{
+  auto count = stack.size () - base;
+  if (count == 0)
+    return nullptr;
+
+  auto copy = static_cast <T*> (_arena.allocate (count * sizeof (T), alignof (T)));
+  std::copy (stack.begin () + base, stack.end (), copy);
+  stack.resize (base);
+  return copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copies raw string content into the arena, so the document does not depend
+// on the lifetime of its input.
+std::string_view json::document::store (std::string_view content)
+{
+  if (content.empty ())
+    return std::string_view ();
+
+  auto copy = static_cast <char*> (_arena.allocate (content.length (), 1));
+  std::memcpy (copy, content.data (), content.length ());
+  return std::string_view (copy, content.length ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -168,10 +168,9 @@ time_t Duration::toTime_t () const
 ////////////////////////////////////////////////////////////////////////////////
 bool Duration::parse (const std::string& input, std::string::size_type& start)
 {
-  auto i = start;
-  Pig pig (input);
-  if (i)
-    pig.skipN (static_cast <int> (i));
+  Pig pig {std::string_view (input)};
+  if (! pig.seek (start))
+    return false;
 
   if (Duration::standaloneSecondsEnabled && parse_seconds (pig))
   {
@@ -25,9 +25,17 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <JSON.h>
+#include <charconv>
 #include <format.h>
+#include <functional>
+#include <scan.h>
+#include <shared.h>
 #include <utf8.h>
 
+// Objects larger than this are given a hash index; smaller ones are searched
+// linearly, which is faster for them and needs no extra memory.
+static const std::size_t indexThreshold = 16;
+
 const char *json_encode[] = {
   "\x00", "\x01", "\x02", "\x03", "\x04", "\x05", "\x06", "\x07",
    "\\b",  "\\t",  "\\n", "\x0b",  "\\f",  "\\r", "\x0e", "\x0f",
@@ -86,7 +94,16 @@ json::jtype json::value::type ()
 ////////////////////////////////////////////////////////////////////////////////
 std::string json::value::dump () const
 {
-  return "<value>";
+  std::string output;
+  Writer writer (output);
+  write (writer);
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::value::write (Writer& writer) const
+{
+  writer.raw ("<value>");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -116,25 +133,61 @@ json::jtype json::string::type ()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string json::string::dump () const
+// The content is kept as it appeared between the quotes, so it is already
+// encoded.
+void json::string::write (Writer& writer) const
 {
-  return std::string ("\"") + _data + '"';
+  writer.encodedValue (_data);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 json::number* json::number::parse (Pig& pig)
 {
-  double d;
-  if (pig.getNumber (d))
+  std::string_view text;
+  if (pig.getNumber (text))
   {
     auto s = new json::number ();
-    s->_dvalue = d;
+    convert (text, *s);
     return s;
   }
 
   return nullptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Converts the text of a number, as matched by Pig::getNumber, to the first of
+// int64_t, uint64_t or double that holds it.
+bool json::number::convert (std::string_view text, number& result)
+{
+  auto first = text.data ();
+  auto last  = first + text.length ();
+  if (first != last && *first == '+')
+    ++first;
+
+  int64_t ivalue;
+  auto converted = std::from_chars (first, last, ivalue);
+  if (converted.ec == std::errc () && converted.ptr == last)
+  {
+    result._kind   = intvalue;
+    result._ivalue = ivalue;
+    result._dvalue = (double) ivalue;
+    return true;
+  }
+
+  uint64_t uvalue;
+  converted = std::from_chars (first, last, uvalue);
+  if (converted.ec == std::errc () && converted.ptr == last)
+  {
+    result._kind   = uintvalue;
+    result._uvalue = uvalue;
+    result._dvalue = (double) uvalue;
+    return true;
+  }
+
+  result._kind = realvalue;
+  return parseDouble (text, result._dvalue);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 json::jtype json::number::type ()
 {
@@ -142,9 +195,11 @@ json::jtype json::number::type ()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string json::number::dump () const
+void json::number::write (Writer& writer) const
 {
-  return format (_dvalue);
+       if (_kind == intvalue)  writer.value (_ivalue);
+  else if (_kind == uintvalue) writer.value (_uvalue);
+  else                         writer.value (_dvalue);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -185,11 +240,12 @@ json::jtype json::literal::type ()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string json::literal::dump () const
+void json::literal::write (Writer& writer) const
 {
-       if (_lvalue == nullvalue)  return "null";
-  else if (_lvalue == falsevalue) return "false";
-  else                            return "true";
+  if (_lvalue == nullvalue)
+    writer.null ();
+  else
+    writer.value (_lvalue != falsevalue);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -253,21 +309,175 @@ json::jtype json::array::type ()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string json::array::dump () const
+void json::array::write (Writer& writer) const
 {
-  std::string output;
-  output += '[';
+  writer.beginArray ();
+  for (auto& i : _data)
+    i->write (writer);
+
+  writer.endArray ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::members::iterator json::members::find (std::string_view key)
+{
+  return _items.begin () + locate (key);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::members::const_iterator json::members::find (std::string_view key) const
+{
+  return _items.begin () + locate (key);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::members::size_type json::members::count (std::string_view key) const
+{
+  return locate (key) == _items.size () ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::value*& json::members::operator[] (const std::string& key)
+{
+  return insert (value_type (key, nullptr)).first->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::value*& json::members::at (std::string_view key)
+{
+  auto position = locate (key);
+  if (position == _items.size ())
+    throw format ("Error: missing object member '{1}'", std::string (key));
+
+  return _items[position].second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::value* const& json::members::at (std::string_view key) const
+{
+  auto position = locate (key);
+  if (position == _items.size ())
+    throw format ("Error: missing object member '{1}'", std::string (key));
+
+  return _items[position].second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::pair <json::members::iterator, bool> json::members::insert (value_type&& item)
+{
+  auto position = locate (item.first);
+  if (position != _items.size ())
+    return {_items.begin () + position, false};
+
+  _items.push_back (std::move (item));
+  index (position);
+  return {_items.begin () + position, true};
+}
 
-  for (auto i = _data.begin (); i != _data.end (); ++i)
+////////////////////////////////////////////////////////////////////////////////
+std::pair <json::members::iterator, bool> json::members::insert (const value_type& item)
+{
+  return insert (value_type (item));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::members::iterator json::members::erase (const_iterator position)
+{
+  auto next = _items.erase (position);
+  reindex ();
+  return next;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::members::size_type json::members::erase (std::string_view key)
+{
+  auto position = locate (key);
+  if (position == _items.size ())
+    return 0;
+
+  erase (_items.begin () + position);
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::members::reserve (size_type size)
+{
+  _items.reserve (size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::members::clear ()
+{
+  _items.clear ();
+  _index.clear ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns the position of the key, or size () when absent.
+json::members::size_type json::members::locate (std::string_view key) const
+{
+  if (_index.empty ())
   {
-    if (i != _data.begin ())
-      output += ',';
+    for (size_type i = 0; i < _items.size (); ++i)
+      if (_items[i].first == key)
+        return i;
 
-    output += (*i)->dump ();
+    return _items.size ();
   }
 
-  output += ']';
-  return output;
+  // Open addressing with linear probing.  The table is at most half full, so
+  // there is always an empty slot to end the search.
+  auto mask = _index.size () - 1;
+  for (auto slot = std::hash <std::string_view> () (key) & mask; _index[slot]; slot = (slot + 1) & mask)
+    if (_items[_index[slot] - 1].first == key)
+      return _index[slot] - 1;
+
+  return _items.size ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Adds the newly appended item at position to the hash index, creating or
+// growing the index as needed.
+void json::members::index (size_type position)
+{
+  if (_items.size () <= indexThreshold)
+    return;
+
+  if (_index.size () < 2 * _items.size ())
+  {
+    reindex ();
+    return;
+  }
+
+  auto mask = _index.size () - 1;
+  auto slot = std::hash <std::string_view> () (_items[position].first) & mask;
+  while (_index[slot])
+    slot = (slot + 1) & mask;
+
+  _index[slot] = position + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::members::reindex ()
+{
+  _index.clear ();
+  if (_items.size () <= indexThreshold)
+    return;
+
+  size_type slots = 2 * indexThreshold;
+  while (slots < 4 * _items.size ())
+    slots *= 2;
+
+  _index.resize (slots, 0);
+  auto mask = slots - 1;
+  for (size_type i = 0; i < _items.size (); ++i)
+  {
+    auto slot = std::hash <std::string_view> () (_items[i].first) & mask;
+    while (_index[slot])
+      slot = (slot + 1) & mask;
+
+    _index[slot] = i + 1;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -293,7 +503,7 @@ json::object* json::object::parse (Pig& pig)
     json::value* value;
     if (json::object::parse_pair (pig, name, value))
     {
-      obj->_data.insert (std::pair <std::string, json::value*> (name, value));
+      obj->_data.insert (json::members::value_type (std::move (name), value));
       value = nullptr; // Not a leak.  Looks like a leak.
 
       pig.skipWS ();
@@ -303,7 +513,10 @@ json::object* json::object::parse (Pig& pig)
 
         if (json::object::parse_pair (pig, name, value))
         {
-          obj->_data.insert (std::pair <std::string, json::value*> (name, value));
+          // The first of any duplicate names wins.
+          if (! obj->_data.insert (json::members::value_type (std::move (name), value)).second)
+            delete value;
+
           pig.skipWS ();
         }
         else
@@ -360,22 +573,16 @@ json::jtype json::object::type ()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string json::object::dump () const
+void json::object::write (Writer& writer) const
 {
-  std::string output;
-  output += '{';
-
-  for (auto i = _data.begin (); i != _data.end (); ++i)
+  writer.beginObject ();
+  for (auto& i : _data)
   {
-    if (i != _data.begin ())
-      output += ',';
-
-    output += '"' + i->first + "\":";
-    output += i->second->dump ();
+    writer.encodedKey (i.first);
+    i.second->write (writer);
   }
 
-  output += '}';
-  return output;
+  writer.endObject ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -383,7 +590,7 @@ json::value* json::parse (const std::string& input)
 {
   json::value* root = nullptr;
 
-  Pig n (input);
+  Pig n {std::string_view (input)};
   n.skipWS ();
 
        if (n.peek () == '{') root = json::object::parse (n);
@@ -407,32 +614,25 @@ std::string json::encode (const std::string& input)
 {
   std::string output;
   output.reserve ((input.size () * 6) / 5);  // 20% increase.
+  encode (output, input);
+  return output;
+}
 
-  auto last = input.begin ();
-  for (auto i = input.begin (); i != input.end (); ++i)
+////////////////////////////////////////////////////////////////////////////////
+// Appends the encoded input to output.  Runs of bytes that need no escape are
+// found a vector at a time and copied whole.
+void json::encode (std::string& output, std::string_view input)
+{
+  auto data = input.data ();
+  auto length = input.length ();
+  for (std::size_t i = 0; i < length; ++i)
   {
-    switch (*i)
-    {
-    // Simple translations.
-    case  '"':
-    case '\\':
-    case  '/':
-    case '\b':
-    case '\f':
-    case '\n':
-    case '\r':
-    case '\t':
-      output.append (last, i);
-      output += json_encode[(unsigned char)(*i)];
-      last = i + 1;
-
-    // Default NOP.
-    }
+    auto plain = scan_json_plain (data + i, length - i);
+    output.append (data + i, plain);
+    i += plain;
+    if (i < length)
+      output += json_encode[(unsigned char) data[i]];
   }
-
-  output.append (last, input.end ());
-
-  return output;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -460,9 +660,10 @@ std::string json::decode (const std::string& input)
         case 'r':  output += '\r'; break;
         case 't':  output += '\t'; break;
 
-        // Compose a UTF8 unicode character.
+        // Compose a UTF8 unicode character.  Only the six bytes utf8_codepoint
+        // may read are copied, not the rest of the input.
         case 'u':
-          output += utf8_character (utf8_codepoint (input.substr (++pos)));
+          output += utf8_character (utf8_codepoint (input.substr (++pos, 6)));
           pos += 3;
           break;
 
@@ -481,9 +682,9 @@ std::string json::decode (const std::string& input)
     }
     else
     {
-      size_t next_backslash = input.find ('\\', pos);
-      output.append (input, pos, next_backslash - pos);
-      pos = next_backslash;
+      auto plain = scan_until (input.data () + pos, input.length () - pos, '\\', '\\');
+      output.append (input, pos, plain);
+      pos += plain;
     }
   }
 
@@ -28,9 +28,14 @@
 #define INCLUDED_JSON
 
 #include <Pig.h>
+#include <cstddef>
 #include <cstdint>
-#include <map>
+#include <iosfwd>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace json
@@ -45,6 +50,8 @@ namespace json
     j_literal   // 5
   };
 
+  class Writer;
+
   class value
   {
   public:
@@ -53,6 +60,7 @@ namespace json
     static value* parse (Pig&);
     virtual jtype type ();
     virtual std::string dump () const;
+    virtual void write (Writer&) const;
   };
 
   class string : public value
@@ -63,24 +71,31 @@ namespace json
     ~string () {}
     static string* parse (Pig&);
     jtype type ();
-    std::string dump () const;
+    void write (Writer&) const;
 
   public:
     std::string _data;
   };
 
+  // Integers that fit in 64 bits are kept exactly, with _dvalue holding the
+  // nearest double for callers that only want that.
   class number : public value
   {
   public:
     number () : _dvalue (0.0) {}
     ~number () {}
     static number* parse (Pig&);
+    static bool convert (std::string_view, number&);
     jtype type ();
-    std::string dump () const;
+    void write (Writer&) const;
     operator double () const;
 
   public:
-    double _dvalue;
+    enum number_kind {realvalue, intvalue, uintvalue};
+    double      _dvalue;
+    int64_t     _ivalue {0};
+    uint64_t    _uvalue {0};
+    number_kind _kind   {realvalue};
   };
 
   class literal : public value
@@ -90,7 +105,7 @@ namespace json
     ~literal () {}
     static literal* parse (Pig&);
     jtype type ();
-    std::string dump () const;
+    void write (Writer&) const;
 
   public:
     enum literal_value {none, nullvalue, falsevalue, truevalue};
@@ -104,12 +119,57 @@ namespace json
     ~array ();
     static array* parse (Pig&);
     jtype type ();
-    std::string dump () const;
+    void write (Writer&) const;
 
   public:
     std::vector <value*> _data;
   };
 
+  // Object member storage.  A flat vector that keeps members in insertion
+  // order, with the subset of the std::map interface that callers use.  Small
+  // objects are searched linearly; larger ones also maintain a hash index.
+  class members
+  {
+  public:
+    using key_type       = std::string;
+    using mapped_type    = value*;
+    using value_type     = std::pair <std::string, value*>;
+    using iterator       = std::vector <value_type>::iterator;
+    using const_iterator = std::vector <value_type>::const_iterator;
+    using size_type      = std::size_t;
+
+    iterator begin ()             { return _items.begin (); }
+    iterator end ()               { return _items.end ();   }
+    const_iterator begin () const { return _items.begin (); }
+    const_iterator end () const   { return _items.end ();   }
+    size_type size () const       { return _items.size ();  }
+    bool empty () const           { return _items.empty (); }
+
+    iterator find (std::string_view);
+    const_iterator find (std::string_view) const;
+    size_type count (std::string_view) const;
+    value*& operator[] (const std::string&);
+    value*& at (std::string_view);
+    value* const& at (std::string_view) const;
+
+    // As with std::map, inserting an existing key changes nothing.
+    std::pair <iterator, bool> insert (value_type&&);
+    std::pair <iterator, bool> insert (const value_type&);
+    iterator erase (const_iterator);
+    size_type erase (std::string_view);
+    void reserve (size_type);
+    void clear ();
+
+  private:
+    size_type locate (std::string_view) const;
+    void index (size_type);
+    void reindex ();
+
+  private:
+    std::vector <value_type> _items {};
+    std::vector <size_type>  _index {};   // Position + 1, or 0 when empty.
+  };
+
   class object : public value
   {
   public:
@@ -118,19 +178,324 @@ namespace json
     static object* parse (Pig&);
     static bool parse_pair (Pig&, std::string&, value*&);
     jtype type ();
-    std::string dump () const;
+    void write (Writer&) const;
 
   public:
-    std::map <std::string, value*> _data;
+    members _data;
   };
 
   // Parser entry point.
   value* parse (const std::string&);
 
+  // Monotonic allocator.  Memory is handed out sequentially from large blocks,
+  // and is only released, all at once, when the arena is destroyed.
+  class arena
+  {
+  public:
+    arena () = default;
+    arena (const arena&) = delete;
+    arena& operator= (const arena&) = delete;
+    arena (arena&&) = default;
+    arena& operator= (arena&&) = default;
+
+    void* allocate (std::size_t, std::size_t);
+
+  private:
+    std::vector <std::unique_ptr <char[]>> _blocks    {};
+    char*                                  _next      {nullptr};
+    std::size_t                            _available {0};
+    std::size_t                            _size      {512};
+  };
+
+  // A node of a json::document.  Elements have no destructor and no vtable,
+  // and are released with the arena of the document that owns them.
+  class element
+  {
+  public:
+    element () : _number (0.0) {}
+    jtype type () const;
+    std::string dump () const;
+    void dump (std::string&) const;
+    void write (Writer&) const;
+
+    // j_string: the content between the quotes, as it appears in the input.
+    std::string_view str () const;
+
+    // j_number, j_literal.  An integer is exact in ivalue or uvalue, as given
+    // by kind, and those are zero for any other number.
+    double number () const;
+    json::number::number_kind kind () const;
+    int64_t ivalue () const;
+    uint64_t uvalue () const;
+    literal::literal_value lvalue () const;
+
+    // j_array, j_object: elements or member values by index.
+    std::size_t size () const;
+    const element& operator[] (std::size_t) const;
+
+    // j_object: member names by index, or member values by name.
+    std::string_view key (std::size_t) const;
+    const element* find (std::string_view) const;
+
+  private:
+    friend class document;
+
+    struct children
+    {
+      element*          items;
+      std::string_view* keys;   // j_object only
+      std::size_t       count;
+    };
+
+    jtype                     _type {j_value};
+    json::number::number_kind _kind {json::number::realvalue};   // j_number only
+    union
+    {
+      double                 _number;
+      int64_t                _ivalue;
+      uint64_t               _uvalue;
+      literal::literal_value _lvalue;
+      std::string_view       _string;
+      children               _children;
+    };
+  };
+
+  // A parsed document, with all its elements, strings and member names held
+  // in one arena.  Object members remain in their input order.
+  class document
+  {
+  public:
+    document () = default;
+    explicit document (const std::string&);
+
+    const element& root () const;
+    std::string dump () const;
+
+  private:
+    struct scratch;
+    bool parse_value  (Pig&, element&, scratch&);
+    bool parse_object (Pig&, element&, scratch&);
+    bool parse_array  (Pig&, element&, scratch&);
+    bool parse_pair   (Pig&, scratch&);
+    std::string_view store (std::string_view);
+    template <typename T> T* store (std::vector <T>&, std::size_t);
+
+  private:
+    arena   _arena {};
+    element _root  {};
+  };
+
+  class lazy_document;
+
+  // A value in a lazy_document.  Nothing is decoded until it is asked for, and
+  // a value that is not found is an element of type j_value, which is false.
+  class lazy_element
+  {
+  public:
+    class iterator
+    {
+    public:
+      lazy_element operator* () const;
+      iterator& operator++ ();
+      bool operator!= (const iterator&) const;
+      std::string_view key () const;   // j_object only, still encoded
+
+    private:
+      friend class lazy_element;
+      const lazy_document* _document  {nullptr};
+      std::size_t          _container {0};
+      std::size_t          _child     {0};
+    };
+
+    lazy_element () = default;
+    explicit operator bool () const;
+    jtype type () const;
+
+    // j_string: str () is the content as it appears in the input, and text ()
+    // the content with escapes decoded.
+    std::string_view str () const;
+    std::string text () const;
+
+    // j_number, j_literal
+    double number () const;
+    json::number::number_kind kind () const;
+    int64_t ivalue () const;
+    uint64_t uvalue () const;
+    literal::literal_value lvalue () const;
+
+    // j_array, j_object.  Finding a child walks past the ones before it,
+    // skipping over their contents without examining them.
+    std::size_t size () const;
+    lazy_element operator[] (std::size_t) const;
+    lazy_element find (std::string_view) const;
+    lazy_element pointer (std::string_view) const;
+    iterator begin () const;
+    iterator end () const;
+
+  private:
+    friend class lazy_document;
+    lazy_element (const lazy_document*, std::size_t);
+    std::string_view scalar () const;
+    json::number numeric () const;
+
+  private:
+    const lazy_document* _document {nullptr};
+    std::size_t          _token    {0};
+  };
+
+  // A document that is only indexed when constructed: the offsets of its
+  // structural characters are found with vector instructions, and each
+  // bracket is paired with the one that closes it.  Values are decoded only
+  // when accessed, and subtrees that are not visited cost nothing more.  The
+  // text is not copied, and must outlive the document.  Scalars are checked
+  // only when read.
+  class lazy_document
+  {
+  public:
+    explicit lazy_document (std::string_view);
+
+    lazy_element root () const;
+
+    // RFC 6901 JSON Pointer, such as "/tags/0" or "/a~1b" for the member
+    // "a/b".  The empty pointer is the root.
+    lazy_element pointer (std::string_view) const;
+
+  private:
+    friend class lazy_element;
+    char at (std::size_t) const;
+    std::size_t skip (std::size_t) const;
+    std::size_t first (std::size_t) const;
+    std::size_t next (std::size_t, std::size_t) const;
+    void check (std::size_t, std::size_t) const;
+
+  private:
+    std::string_view       _text   {};
+    std::vector <uint32_t> _tokens {};   // Offsets, from scan_json_structure.
+    std::vector <uint32_t> _close  {};   // Per opening bracket, its closing token.
+  };
+
+  // An owned value, held by value rather than through a pointer.  Nodes are
+  // move-only: moving one into an array or object, or taking it out of one,
+  // transfers the whole subtree without copying it, so subtrees can be
+  // spliced between documents.  clone () makes the deep copy explicit.
+  // Strings and member names are held decoded, and members keep their order.
+  class node
+  {
+  public:
+    using array_type  = std::vector <node>;
+    using object_type = std::vector <std::pair <std::string, node>>;
+
+    node () = default;   // null
+    node (std::nullptr_t) {}
+    node (bool);
+    node (int);
+    node (int64_t);
+    node (uint64_t);
+    node (double);
+    node (const char*);
+    node (std::string_view);
+    node (std::string&&);
+    explicit node (jtype);   // An empty j_array or j_object.
+    explicit node (std::unique_ptr <value>);
+    explicit node (const element&);
+
+    node (node&&) noexcept = default;
+    node& operator= (node&&) noexcept = default;
+    node (const node&) = delete;
+    node& operator= (const node&) = delete;
+
+    static node parse (const std::string&);
+    node clone () const;
+
+    jtype type () const;
+    std::string dump () const;
+    void write (Writer&) const;
+
+    // j_string, j_number, j_literal, with zero or empty for any other type.
+    std::string_view str () const;
+    double number () const;
+    json::number::number_kind kind () const;
+    int64_t ivalue () const;
+    uint64_t uvalue () const;
+    literal::literal_value lvalue () const;
+
+    // j_array, j_object: elements or member values by index.
+    std::size_t size () const;
+    node& operator[] (std::size_t);
+    const node& operator[] (std::size_t) const;
+
+    // j_object: member names by index, or member values by name.
+    std::string_view key (std::size_t) const;
+    node* find (std::string_view);
+    const node* find (std::string_view) const;
+
+    // Building and splicing.  set replaces the value of an existing member,
+    // and take removes an element or member and returns its value.
+    node& push_back (node&&);
+    node& set (std::string_view, node&&);
+    node take (std::size_t);
+    node take (std::string_view);
+    void reserve (std::size_t);
+
+  private:
+    array_type& as_array ();
+    object_type& as_object ();
+
+  private:
+    std::variant <std::monostate, bool, int64_t, uint64_t, double, std::string,
+                  array_type, object_type> _data {};
+  };
+
   // Encode/decode for JSON entities.
   std::string encode (const std::string&);
+  void encode (std::string&, std::string_view);
   std::string decode (const std::string&);
 
+  // Serializer that emits JSON in one pass, appending to a string or writing
+  // to a stream.  Names and strings are escaped with encode, unless they are
+  // already encoded, as those in a parsed tree are.  An indent of zero gives
+  // compact output, and otherwise one member or element per line.
+  class Writer
+  {
+  public:
+    explicit Writer (std::string&, int indent = 0);
+    explicit Writer (std::ostream&, int indent = 0);
+    Writer (const Writer&) = delete;
+    Writer& operator= (const Writer&) = delete;
+    ~Writer ();
+
+    void beginObject ();
+    void endObject ();
+    void beginArray ();
+    void endArray ();
+    void key (std::string_view);
+    void encodedKey (std::string_view);
+    void value (std::string_view);
+    void value (const char*);
+    void value (double);
+    void value (int64_t);
+    void value (uint64_t);
+    void value (int);
+    void value (bool);
+    void null ();
+    void encodedValue (std::string_view);
+    void raw (std::string_view);
+    void flush ();
+
+  private:
+    void separate ();
+    void close (char);
+
+  private:
+    std::string   _buffer {};
+    std::string&  _output;
+    std::ostream* _stream {nullptr};
+    int           _indent {0};
+    int           _depth  {0};
+    bool          _first  {true};    // Nothing yet in the current container.
+    bool          _named  {false};   // A key awaits its value.
+  };
+
   class SAX
   {
   public:
@@ -152,31 +517,147 @@ namespace json
       virtual void eventValueString (const std::string&) {}
     };
 
+    // As Sink, but names and string values are delivered as views, which are
+    // only valid during the call.  A string without escapes is viewed in the
+    // input, and one with escapes in a reused buffer, so neither allocates.
+    class ViewSink
+    {
+    public:
+      virtual ~ViewSink () {}
+      virtual void eventDocStart () {}
+      virtual void eventDocEnd () {}
+      virtual void eventObjectStart () {}
+      virtual void eventObjectEnd (int) {}
+      virtual void eventArrayStart () {}
+      virtual void eventArrayEnd (int) {}
+      virtual void eventName (std::string_view) {}
+      virtual void eventValueNull () {}
+      virtual void eventValueBool (bool) {}
+      virtual void eventValueInt (int64_t) {}
+      virtual void eventValueUint (uint64_t) {}
+      virtual void eventValueDouble (double) {}
+      virtual void eventValueString (std::string_view) {}
+    };
+
     bool parse (const std::string&, json::SAX::Sink&);
+    bool parse (const std::string&, json::SAX::ViewSink&);
+
+    // As parse, in two stages.  The first indexes the structure of the whole
+    // input with vector instructions.  The second walks that index, token by
+    // token, instead of examining every byte.  The events, and any error, are
+    // the same as from parse.
+    bool parseIndexed (const std::string&, json::SAX::Sink&);
+    bool parseIndexed (const std::string&, json::SAX::ViewSink&);
+
+    // Push parser for input that arrives in pieces, such as from a pipe or a
+    // socket.  Chunks may split the input anywhere, even within a token.
+    // Memory use depends on the nesting depth and the longest string, and not
+    // on the size of the document.
+    class Stream
+    {
+    public:
+      explicit Stream (Sink&);
+      explicit Stream (ViewSink&);
+      void feed (const char*, std::size_t);
+      void finish ();
+
+    private:
+      void consume (char);
+      bool beginValue (char);
+      void endValue ();
+      void endString ();
+      void endNumber ();
+      static bool isSpace (char);
+
+    private:
+      enum class state {start, value, member, element, colon, separator,
+                        string, escape, unicode, number, literal, done};
+
+      std::unique_ptr <ViewSink> _adapter {};         // Wraps a classic Sink.
+      ViewSink&                  _sink;
+      state                      _state  {state::start};
+      std::size_t                _offset {0};
+      std::vector <char>         _open   {};         // '{' or '[' per nesting level.
+      std::vector <int>          _counts {};         // Members per nesting level.
+      std::string                _token  {};         // String content, or number text.
+      bool                       _key    {false};    // Whether the string is a name.
+      std::string                _hex    {};         // Digits of a \uXXXX escape.
+      const char*                _expect {nullptr};  // Remainder of a literal.
+    };
 
   private:
     void ignoreWhitespace (const std::string&, std::string::size_type&);
-    bool isObject         (const std::string&, std::string::size_type&, SAX::Sink&);
-    bool isArray          (const std::string&, std::string::size_type&, SAX::Sink&);
-    bool isPair           (const std::string&, std::string::size_type&, SAX::Sink&);
-    bool isValue          (const std::string&, std::string::size_type&, SAX::Sink&);
-    bool isKey            (const std::string&, std::string::size_type&, SAX::Sink&);
-    bool isString         (const std::string&, std::string::size_type&, SAX::Sink&);
-    bool isStringValue    (const std::string&, std::string::size_type&, std::string&);
-    bool isNumber         (const std::string&, std::string::size_type&, SAX::Sink&);
+    bool isObject         (const std::string&, std::string::size_type&, SAX::ViewSink&);
+    bool isArray          (const std::string&, std::string::size_type&, SAX::ViewSink&);
+    bool isPair           (const std::string&, std::string::size_type&, SAX::ViewSink&);
+    bool isValue          (const std::string&, std::string::size_type&, SAX::ViewSink&);
+    bool isKey            (const std::string&, std::string::size_type&, SAX::ViewSink&);
+    bool isString         (const std::string&, std::string::size_type&, SAX::ViewSink&);
+    bool isStringValue    (const std::string&, std::string::size_type&, std::string_view&);
+    bool isNumber         (const std::string&, std::string::size_type&, SAX::ViewSink&);
     bool isInt            (const std::string&, std::string::size_type&, std::string&);
     bool isFrac           (const std::string&, std::string::size_type&, std::string&);
     bool isDigits         (const std::string&, std::string::size_type&);
-    bool isDecDigit       (int);
-    bool isHexDigit       (int);
-    int  hexToInt         (int);
-    int  hexToInt         (int, int, int, int);
     bool isExp            (const std::string&, std::string::size_type&, std::string&);
     bool isE              (const std::string&, std::string::size_type&);
-    bool isBool           (const std::string&, std::string::size_type&, SAX::Sink&);
-    bool isNull           (const std::string&, std::string::size_type&, SAX::Sink&);
+    bool isBool           (const std::string&, std::string::size_type&, SAX::ViewSink&);
+    bool isNull           (const std::string&, std::string::size_type&, SAX::ViewSink&);
     bool isLiteral        (const std::string&, char, std::string::size_type&);
-    void error            (const std::string&, std::string::size_type);
+
+    static bool isDecDigit (int);
+    static bool isHexDigit (int);
+    static int  hexToInt   (int);
+    static int  hexToInt   (int, int, int, int);
+    static bool number     (std::string_view, SAX::ViewSink&);
+    static void error      (const std::string&, std::string::size_type);
+
+    bool isIndexedDocument (const std::string&, SAX::ViewSink&, std::size_t&);
+    bool isIndexedString   (const std::string&, std::size_t, std::string_view&);
+    bool isIndexedNumber   (const std::string&, std::size_t, SAX::ViewSink&);
+    bool nextIndexed       (const std::string&, std::string::size_type, std::size_t&);
+    std::string::size_type nextToken (const std::string&, std::string::size_type);
+
+  private:
+    std::string            _scratch {};       // Unescaped content of the current string.
+    std::vector <uint32_t> _index   {};       // Token offsets, from scan_json_structure.
+    std::size_t            _next    {0};      // Position in _index.
+    bool                   _indexed {false};  // Whether _index is in use.
+    bool                   _special {false};  // Whether the input has a backslash or NUL.
+    std::vector <char>     _open    {};       // '{' or '[' per nesting level.
+    std::vector <int>      _counts  {};       // Members per nesting level.
+  };
+
+  // Reader for JSON Lines (NDJSON), with one document per line.  The input is
+  // cut into chunks at line ends, and the chunks are parsed by several threads
+  // at once.  Results are delivered in input order, whichever thread produced
+  // them.  A line that fails to parse is reported by number, and the rest of
+  // the batch carries on.  Blank lines are skipped.
+  class ndjson
+  {
+  public:
+    struct failure
+    {
+      std::size_t line;      // Counted from 1.
+      std::string message;
+    };
+
+    // Zero threads means one per core.
+    explicit ndjson (unsigned int threads = 0);
+
+    // One value per line, in order, and nullptr for a blank or failed line.
+    std::vector <std::unique_ptr <value>> parse (std::string_view, std::vector <failure>&);
+
+    // The events of each document, from eventDocStart to eventDocEnd, in line
+    // order.  A failed line sends none.  The sink is only called from the
+    // calling thread.
+    void parse (std::string_view, SAX::ViewSink&, std::vector <failure>&);
+
+  private:
+    struct chunk;
+    template <typename Work, typename Merge> void run (std::string_view, std::vector <failure>&, Work, Merge);
+
+  private:
+    unsigned int _threads;
   };
 }
 
@@ -0,0 +1,472 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <JSON.h>
+#include <Pig.h>
+#include <format.h>
+#include <scan.h>
+#include <charconv>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+static bool isValueStart (char c)
+{
+  return c != ',' && c != ':' && c != '}' && c != ']';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Indexes the text, and checks that its brackets and quotes are paired, and
+// that it holds exactly one value.
+json::lazy_document::lazy_document (std::string_view text)
+: _text (text)
+{
+  if (text.length () >= UINT32_MAX)
+    throw std::string ("Error: input is too large");
+
+  scan_json_structure (text.data (), text.length (), _tokens);
+  _close.resize (_tokens.size (), 0);
+
+  std::vector <std::size_t> open;
+  bool quoted = false;
+  for (std::size_t i = 0; i < _tokens.size (); ++i)
+  {
+    auto c = at (i);
+    if (c == '"')
+      quoted = ! quoted;
+
+    else if (c == '{' || c == '[')
+      open.push_back (i);
+
+    else if (c == '}' || c == ']')
+    {
+      if (open.empty () || at (open.back ()) != (c == '}' ? '{' : '['))
+        throw format ("Error: unexpected '{1}' at position {2}", c, (int) _tokens[i]);
+
+      _close[open.back ()] = i;
+      open.pop_back ();
+    }
+  }
+
+  if (quoted)
+    throw format ("Error: missing '\"' at position {1}", (int) text.length ());
+
+  if (! open.empty ())
+    throw format (at (open.back ()) == '{' ? "Error: missing '}' at position {1}"
+                                           : "Error: missing ']' at position {1}", (int) text.length ());
+
+  // As with json::parse, the root is an object or array.
+  if (_tokens.empty () || (at (0) != '{' && at (0) != '['))
+    throw format ("Error: expected '{' or '[' at position {1}", (int) (_tokens.empty () ? 0 : _tokens[0]));
+
+  if (skip (0) != _tokens.size ())
+    throw format ("Error: extra characters found at position {1}", (int) _tokens[skip (0)]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::lazy_element json::lazy_document::root () const
+{
+  return lazy_element (this, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::lazy_element json::lazy_document::pointer (std::string_view path) const
+{
+  return root ().pointer (path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+char json::lazy_document::at (std::size_t token) const
+{
+  return _text[_tokens[token]];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns the token that follows the value starting at token.  A container is
+// passed over in one step, and a string is its two quotes.
+std::size_t json::lazy_document::skip (std::size_t token) const
+{
+  auto c = at (token);
+  if (c == '{' || c == '[')
+    return _close[token] + 1;
+
+  if (c == '"')
+    return token + 2;
+
+  return token + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns the token of the first child of the container, or its closing token
+// when it is empty.  The child of an object is the name of a member, and the
+// value follows three tokens later, after the closing quote and the colon.
+std::size_t json::lazy_document::first (std::size_t container) const
+{
+  auto child = container + 1;
+  if (child != _close[container])
+    check (container, child);
+
+  return child;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns the token of the child after child, or the closing token.
+std::size_t json::lazy_document::next (std::size_t container, std::size_t child) const
+{
+  auto close = _close[container];
+  auto end = skip (at (container) == '{' ? child + 3 : child);
+  if (end == close)
+    return end;
+
+  if (at (end) != ',')
+    throw format (at (container) == '{' ? "Error: missing '}' at position {1}"
+                                        : "Error: missing ']' at position {1}", (int) _tokens[end]);
+
+  if (end + 1 == close)
+    throw format ("Error: missing value after ',' at position {1}", (int) _tokens[end]);
+
+  check (container, end + 1);
+  return end + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Checks that a child, other than the closing token, is a value, or for an
+// object a name, colon and value.
+void json::lazy_document::check (std::size_t container, std::size_t child) const
+{
+  if (at (container) == '{')
+  {
+    if (at (child) != '"')
+      throw format ("Error: missing name at position {1}", (int) _tokens[child]);
+
+    if (at (child + 2) != ':')
+      throw format ("Error: missing ':' at position {1}", (int) _tokens[child + 2]);
+
+    if (child + 3 >= _close[container] || ! isValueStart (at (child + 3)))
+      throw format ("Error: missing value at position {1}", (int) _tokens[child + 3]);
+  }
+  else if (! isValueStart (at (child)))
+    throw format ("Error: missing value at position {1}", (int) _tokens[child]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::lazy_element::lazy_element (const lazy_document* document, std::size_t token)
+: _document (document)
+, _token (token)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::lazy_element::operator bool () const
+{
+  return _document != nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::jtype json::lazy_element::type () const
+{
+  if (! _document)
+    return j_value;
+
+  switch (_document->at (_token))
+  {
+  case '{': return j_object;
+  case '[': return j_array;
+  case '"': return j_string;
+  case 't':
+  case 'f':
+  case 'n': return j_literal;
+  case '-':
+  case '+':
+  case '0': case '1': case '2': case '3': case '4':
+  case '5': case '6': case '7': case '8': case '9':
+            return j_number;
+  }
+
+  throw format ("Error: unexpected '{1}' at position {2}", _document->at (_token), (int) _document->_tokens[_token]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string_view json::lazy_element::str () const
+{
+  if (type () != j_string)
+    return std::string_view ();
+
+  auto start = _document->_tokens[_token] + 1;
+  return _document->_text.substr (start, _document->_tokens[_token + 1] - start);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string json::lazy_element::text () const
+{
+  auto content = str ();
+  if (std::memchr (content.data (), '\\', content.length ()))
+    return json::decode (std::string (content));
+
+  return std::string (content);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The text of a number or literal, which runs up to the next token, less any
+// whitespace.
+std::string_view json::lazy_element::scalar () const
+{
+  auto start = _document->_tokens[_token];
+  auto end = _token + 1 < _document->_tokens.size () ? _document->_tokens[_token + 1]
+                                                     : _document->_text.length ();
+  while (end > start &&
+         (_document->_text[end - 1] == ' '  || _document->_text[end - 1] == '\t' ||
+          _document->_text[end - 1] == '\n' || _document->_text[end - 1] == '\r'))
+    --end;
+
+  return _document->_text.substr (start, end - start);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Converts the number, which is not checked until now.  The whole of the text
+// must be a number as json::parse reads one, so that "inf" or "1e" are not
+// taken by the conversion.
+json::number json::lazy_element::numeric () const
+{
+  json::number value;
+  if (type () != j_number)
+    return value;
+
+  auto text = scalar ();
+  Pig pig (text);
+  std::string_view matched;
+  if (! pig.getNumber (matched) ||
+      ! pig.eos ()              ||
+      ! json::number::convert (matched, value))
+    throw format ("Error: invalid number at position {1}", (int) _document->_tokens[_token]);
+
+  return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double json::lazy_element::number () const
+{
+  return numeric ()._dvalue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::number::number_kind json::lazy_element::kind () const
+{
+  return numeric ()._kind;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int64_t json::lazy_element::ivalue () const
+{
+  auto value = numeric ();
+  return value._kind == json::number::intvalue ? value._ivalue : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t json::lazy_element::uvalue () const
+{
+  auto value = numeric ();
+  return value._kind == json::number::uintvalue ? value._uvalue : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::literal::literal_value json::lazy_element::lvalue () const
+{
+  if (type () != j_literal)
+    return literal::none;
+
+  auto word = scalar ();
+       if (word == "null")  return literal::nullvalue;
+  else if (word == "false") return literal::falsevalue;
+  else if (word == "true")  return literal::truevalue;
+
+  throw format ("Error: invalid literal at position {1}", (int) _document->_tokens[_token]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t json::lazy_element::size () const
+{
+  std::size_t count = 0;
+  for (auto i = begin (); i != end (); ++i)
+    ++count;
+
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::lazy_element json::lazy_element::operator[] (std::size_t index) const
+{
+  std::size_t count = 0;
+  for (auto i = begin (); i != end (); ++i)
+    if (count++ == index)
+      return *i;
+
+  throw format ("Error: element index {1} out of range", (int) index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Names without escapes, which is nearly all of them, are compared in place.
+// The first of any duplicate names wins.
+json::lazy_element json::lazy_element::find (std::string_view name) const
+{
+  if (type () != j_object)
+    return lazy_element ();
+
+  for (auto i = begin (); i != end (); ++i)
+  {
+    auto key = i.key ();
+    if (std::memchr (key.data (), '\\', key.length ())
+          ? json::decode (std::string (key)) == name
+          : key == name)
+      return *i;
+  }
+
+  return lazy_element ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Follows an RFC 6901 JSON Pointer from this element.  Each reference token
+// names an object member, or, as digits without leading zeros, an array index.
+json::lazy_element json::lazy_element::pointer (std::string_view path) const
+{
+  if (path.empty ())
+    return *this;
+
+  if (path[0] != '/')
+    throw format ("Error: JSON Pointer '{1}' does not start with '/'", std::string (path));
+
+  lazy_element current = *this;
+  std::string token;
+  for (std::size_t start = 1; current; )
+  {
+    auto end = path.find ('/', start);
+    if (end == std::string_view::npos)
+      end = path.length ();
+
+    token.clear ();
+    for (auto i = start; i < end; ++i)
+    {
+      if (path[i] != '~')
+        token += path[i];
+      else if (i + 1 < end && (path[i + 1] == '0' || path[i + 1] == '1'))
+        token += path[++i] == '0' ? '~' : '/';
+      else
+        throw format ("Error: invalid escape in JSON Pointer '{1}'", std::string (path));
+    }
+
+    auto t = current.type ();
+    if (t == j_object)
+      current = current.find (token);
+
+    else if (t == j_array &&
+             ! token.empty () &&
+             token.find_first_not_of ("0123456789") == std::string::npos &&
+             (token[0] != '0' || token.length () == 1))
+    {
+      // An index too large to represent is out of bounds, like any other.
+      unsigned long long index;
+      lazy_element found;
+      if (std::from_chars (token.data (), token.data () + token.length (), index).ec == std::errc ())
+        for (auto i = current.begin (); i != current.end (); ++i)
+          if (index-- == 0)
+          {
+            found = *i;
+            break;
+          }
+
+      current = found;
+    }
+    else
+      current = lazy_element ();
+
+    if (end == path.length ())
+      break;
+
+    start = end + 1;
+  }
+
+  return current;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::lazy_element::iterator json::lazy_element::begin () const
+{
+  iterator i;
+  i._document  = _document;
+  i._container = _token;
+  i._child     = _token;
+
+  auto t = type ();
+  if (t == j_object || t == j_array)
+    i._child = _document->first (_token);
+
+  return i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::lazy_element::iterator json::lazy_element::end () const
+{
+  iterator i;
+  i._document  = _document;
+  i._container = _token;
+  i._child     = _token;
+
+  auto t = type ();
+  if (t == j_object || t == j_array)
+    i._child = _document->_close[_token];
+
+  return i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::lazy_element json::lazy_element::iterator::operator* () const
+{
+  return lazy_element (_document, _document->at (_container) == '{' ? _child + 3 : _child);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::lazy_element::iterator& json::lazy_element::iterator::operator++ ()
+{
+  _child = _document->next (_container, _child);
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool json::lazy_element::iterator::operator!= (const iterator& other) const
+{
+  return _child != other._child;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string_view json::lazy_element::iterator::key () const
+{
+  if (_document->at (_container) != '{')
+    return std::string_view ();
+
+  auto start = _document->_tokens[_child] + 1;
+  return _document->_text.substr (start, _document->_tokens[_child + 1] - start);
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <JSON.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+// Chunks are no smaller than this, so that small inputs are not spread thinly
+// across threads.
+static const std::size_t minimumChunk = 256 * 1024;
+
+// Each round of parsing has this many chunks per thread, so that a thread
+// that finishes early can take another.
+static const std::size_t chunksPerThread = 4;
+
+namespace
+{
+  // A recorded SAX event.  Names and strings are kept in the chunk's text.
+  struct Event
+  {
+    enum class kind {docStart, docEnd, objectStart, objectEnd, arrayStart,
+                     arrayEnd, name, null, boolean, integer, uinteger, real,
+                     string};
+
+    kind        type   {kind::docStart};
+    std::size_t offset {0};
+    std::size_t length {0};
+    union
+    {
+      int64_t  i {0};
+      uint64_t u;
+      double   d;
+    };
+  };
+}
+
+struct json::ndjson::chunk
+{
+  std::string_view                      text     {};
+  std::size_t                           lines    {0};   // Lines in text.
+  std::vector <failure>                 failures {};    // Numbered within the chunk.
+  std::vector <std::unique_ptr <value>> values   {};
+  std::vector <Event>                   events   {};
+  std::string                           strings  {};
+};
+
+namespace
+{
+  // Records events into a chunk, for replay once the chunks before it are
+  // done.
+  class Recorder : public json::SAX::ViewSink
+  {
+  public:
+    Recorder (std::vector <Event>& events, std::string& strings)
+    : _events (events)
+    , _strings (strings)
+    {
+    }
+
+    void eventDocStart () override                      { add (Event::kind::docStart);         }
+    void eventDocEnd () override                        { add (Event::kind::docEnd);           }
+    void eventObjectStart () override                   { add (Event::kind::objectStart);      }
+    void eventObjectEnd (int n) override                { add (Event::kind::objectEnd).i = n;  }
+    void eventArrayStart () override                    { add (Event::kind::arrayStart);       }
+    void eventArrayEnd (int n) override                 { add (Event::kind::arrayEnd).i = n;   }
+    void eventName (std::string_view v) override        { text (Event::kind::name, v);         }
+    void eventValueNull () override                     { add (Event::kind::null);             }
+    void eventValueBool (bool v) override               { add (Event::kind::boolean).i = v;    }
+    void eventValueInt (int64_t v) override             { add (Event::kind::integer).i = v;    }
+    void eventValueUint (uint64_t v) override           { add (Event::kind::uinteger).u = v;   }
+    void eventValueDouble (double v) override           { add (Event::kind::real).d = v;       }
+    void eventValueString (std::string_view v) override { text (Event::kind::string, v);       }
+
+  private:
+    Event& add (Event::kind type)
+    {
+      _events.emplace_back ();
+      _events.back ().type = type;
+      return _events.back ();
+    }
+
+    void text (Event::kind type, std::string_view value)
+    {
+      auto& event = add (type);
+      event.offset = _strings.length ();
+      event.length = value.length ();
+      _strings.append (value.data (), value.length ());
+    }
+
+  private:
+    std::vector <Event>& _events;
+    std::string&         _strings;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void replay (const std::vector <Event>& events, const std::string& strings, json::SAX::ViewSink& sink)
+{
+  for (auto& event : events)
+  {
+    switch (event.type)
+    {
+    case Event::kind::docStart:    sink.eventDocStart ();                   break;
+    case Event::kind::docEnd:      sink.eventDocEnd ();                     break;
+    case Event::kind::objectStart: sink.eventObjectStart ();                break;
+    case Event::kind::objectEnd:   sink.eventObjectEnd ((int) event.i);     break;
+    case Event::kind::arrayStart:  sink.eventArrayStart ();                 break;
+    case Event::kind::arrayEnd:    sink.eventArrayEnd ((int) event.i);      break;
+    case Event::kind::null:        sink.eventValueNull ();                  break;
+    case Event::kind::boolean:     sink.eventValueBool (event.i != 0);      break;
+    case Event::kind::integer:     sink.eventValueInt (event.i);            break;
+    case Event::kind::uinteger:    sink.eventValueUint (event.u);           break;
+    case Event::kind::real:        sink.eventValueDouble (event.d);         break;
+    case Event::kind::name:
+      sink.eventName (std::string_view (strings.data () + event.offset, event.length));
+      break;
+    case Event::kind::string:
+      sink.eventValueString (std::string_view (strings.data () + event.offset, event.length));
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Calls line for each line of the chunk, with its number within the chunk,
+// and records any error against that number.
+template <typename Line>
+static void eachLine (std::string_view text, std::size_t& lines, std::vector <json::ndjson::failure>& failures, Line line)
+{
+  std::string buffer;
+  for (std::size_t start = 0; start < text.length (); )
+  {
+    auto newline = static_cast <const char*> (std::memchr (text.data () + start, '\n', text.length () - start));
+    auto end = newline ? (std::size_t) (newline - text.data ()) : text.length ();
+    buffer.assign (text.data () + start, end - start);
+    ++lines;
+
+    try
+    {
+      line (buffer, buffer.find_first_not_of (" \t\r") == std::string::npos);
+    }
+
+    catch (const std::string& error)
+    {
+      failures.push_back ({lines, error});
+    }
+
+    start = end + 1;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::ndjson::ndjson (unsigned int threads)
+: _threads (threads ? threads : std::max (1u, std::thread::hardware_concurrency ()))
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Parses the text in rounds of chunks.  Within a round, the threads take
+// chunks in turn until none are left, and then the chunks are merged in
+// order.  Memory therefore depends on the size of a round, and not on the
+// size of the input.
+template <typename Work, typename Merge>
+void json::ndjson::run (
+  std::string_view text,
+  std::vector <failure>& failures,
+  Work work,
+  Merge merge)
+{
+  auto size = std::max (minimumChunk, text.length () / (_threads * chunksPerThread * 2) + 1);
+
+  std::size_t start = 0;
+  std::size_t line = 0;
+  std::vector <chunk> round;
+  while (start < text.length ())
+  {
+    // Chunks end just after a newline, or at the end of the text.
+    round.clear ();
+    while (round.size () < _threads * chunksPerThread && start < text.length ())
+    {
+      auto end = std::min (start + size, text.length ());
+      auto newline = static_cast <const char*> (std::memchr (text.data () + end - 1, '\n', text.length () - end + 1));
+      end = newline ? (std::size_t) (newline - text.data ()) + 1 : text.length ();
+
+      round.emplace_back ();
+      round.back ().text = text.substr (start, end - start);
+      start = end;
+    }
+
+    // An exception escaping a thread would terminate the program, so the
+    // first is kept, the remaining chunks are abandoned, and it is rethrown
+    // here once every thread has been joined.
+    std::atomic <std::size_t> next {0};
+    std::exception_ptr error;
+    std::mutex errorLock;
+    auto worker = [&] ()
+    {
+      try
+      {
+        for (std::size_t i; (i = next++) < round.size (); )
+          work (round[i]);
+      }
+
+      catch (...)
+      {
+        std::lock_guard <std::mutex> lock (errorLock);
+        if (! error)
+          error = std::current_exception ();
+
+        next = round.size ();
+      }
+    };
+
+    // A thread that cannot be started leaves its share to the others.
+    std::vector <std::thread> pool;
+    try
+    {
+      for (std::size_t i = 1; i < std::min ((std::size_t) _threads, round.size ()); ++i)
+        pool.emplace_back (worker);
+    }
+
+    catch (const std::system_error&)
+    {
+    }
+
+    worker ();
+    for (auto& thread : pool)
+      thread.join ();
+
+    if (error)
+      std::rethrow_exception (error);
+
+    for (auto& done : round)
+    {
+      for (auto& failed : done.failures)
+        failures.push_back ({line + failed.line, std::move (failed.message)});
+
+      merge (done);
+      line += done.lines;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector <std::unique_ptr <json::value>> json::ndjson::parse (
+  std::string_view text,
+  std::vector <failure>& failures)
+{
+  std::vector <std::unique_ptr <value>> values;
+  run (text, failures,
+    [] (chunk& work)
+    {
+      eachLine (work.text, work.lines, work.failures, [&work] (const std::string& line, bool blank)
+      {
+        work.values.emplace_back (nullptr);
+        if (! blank)
+          work.values.back ().reset (json::parse (line));
+      });
+    },
+    [&values] (chunk& done)
+    {
+      for (auto& value : done.values)
+        values.push_back (std::move (value));
+    });
+
+  return values;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::ndjson::parse (
+  std::string_view text,
+  SAX::ViewSink& sink,
+  std::vector <failure>& failures)
+{
+  run (text, failures,
+    [] (chunk& work)
+    {
+      json::SAX sax;
+      Recorder recorder (work.events, work.strings);
+      eachLine (work.text, work.lines, work.failures, [&] (const std::string& line, bool blank)
+      {
+        if (blank)
+          return;
+
+        // A failed line leaves no events behind.
+        auto events  = work.events.size ();
+        auto strings = work.strings.length ();
+        try
+        {
+          sax.parse (line, recorder);
+        }
+
+        catch (...)
+        {
+          work.events.resize (events);
+          work.strings.resize (strings);
+          throw;
+        }
+      });
+    },
+    [&sink] (chunk& done)
+    {
+      replay (done.events, done.strings, sink);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////
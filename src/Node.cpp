@@ -0,0 +1,500 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <JSON.h>
+#include <format.h>
+#include <algorithm>
+#include <unordered_set>
+
+// Indexes of the alternatives of node::_data.
+enum {n_null, n_bool, n_int, n_uint, n_real, n_string, n_array, n_object};
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::node (bool value)
+: _data (std::in_place_index <n_bool>, value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::node (int value)
+: _data (std::in_place_index <n_int>, value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::node (int64_t value)
+: _data (std::in_place_index <n_int>, value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::node (uint64_t value)
+: _data (std::in_place_index <n_uint>, value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::node (double value)
+: _data (std::in_place_index <n_real>, value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::node (const char* value)
+: _data (std::in_place_index <n_string>, value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::node (std::string_view value)
+: _data (std::in_place_index <n_string>, value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::node (std::string&& value)
+: _data (std::in_place_index <n_string>, std::move (value))
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::node (jtype type)
+{
+       if (type == j_array)  _data.emplace <n_array> ();
+  else if (type == j_object) _data.emplace <n_object> ();
+  else
+    throw format ("Error: a node can only be constructed empty as an array or object, not type {1}", (int) type);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A string from json::parse is still encoded.  Without escapes it is already
+// its own decoding, and is moved rather than copied.
+static std::string decoded (std::string& encoded)
+{
+  if (encoded.find ('\\') == std::string::npos)
+    return std::move (encoded);
+
+  return json::decode (encoded);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Takes over a tree from json::parse.  Strings without escapes are moved out
+// rather than copied, and each value is freed once its contents are taken.
+json::node::node (std::unique_ptr <value> root)
+{
+  if (! root)
+    return;
+
+  switch (root->type ())
+  {
+  case j_string:
+    _data.emplace <n_string> (decoded (static_cast <json::string&> (*root)._data));
+    break;
+
+  case j_number:
+    {
+      auto& n = static_cast <json::number&> (*root);
+           if (n._kind == json::number::intvalue)  _data.emplace <n_int>  (n._ivalue);
+      else if (n._kind == json::number::uintvalue) _data.emplace <n_uint> (n._uvalue);
+      else                                         _data.emplace <n_real> (n._dvalue);
+    }
+    break;
+
+  case j_literal:
+    {
+      auto lvalue = static_cast <json::literal&> (*root)._lvalue;
+      if (lvalue != literal::nullvalue)
+        _data.emplace <n_bool> (lvalue != literal::falsevalue);
+    }
+    break;
+
+  case j_array:
+    {
+      auto& items = static_cast <json::array&> (*root)._data;
+      auto& result = _data.emplace <n_array> ();
+      result.reserve (items.size ());
+      for (auto& item : items)
+        result.emplace_back (std::unique_ptr <value> (std::exchange (item, nullptr)));
+    }
+    break;
+
+  case j_object:
+    {
+      auto& items = static_cast <json::object&> (*root)._data;
+      auto& result = _data.emplace <n_object> ();
+      result.reserve (items.size ());
+      for (auto& item : items)
+      {
+        std::unique_ptr <value> child (std::exchange (item.second, nullptr));
+        result.emplace_back (decoded (item.first), node (std::move (child)));
+      }
+    }
+    break;
+
+  case j_value:
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copies out of a json::document, decoding strings and names.  As with
+// json::parse, the first of any duplicate names wins.
+json::node::node (const element& e)
+{
+  switch (e.type ())
+  {
+  case j_string:
+    _data.emplace <n_string> (json::decode (std::string (e.str ())));
+    break;
+
+  case j_number:
+         if (e.kind () == json::number::intvalue)  _data.emplace <n_int>  (e.ivalue ());
+    else if (e.kind () == json::number::uintvalue) _data.emplace <n_uint> (e.uvalue ());
+    else                                           _data.emplace <n_real> (e.number ());
+    break;
+
+  case j_literal:
+    if (e.lvalue () != literal::nullvalue)
+      _data.emplace <n_bool> (e.lvalue () != literal::falsevalue);
+    break;
+
+  case j_array:
+    {
+      auto& items = _data.emplace <n_array> ();
+      items.reserve (e.size ());
+      for (std::size_t i = 0; i < e.size (); ++i)
+        items.emplace_back (e[i]);
+    }
+    break;
+
+  case j_object:
+    {
+      // Small objects are checked for duplicates linearly, larger ones with a
+      // set of the names seen.
+      auto& items = _data.emplace <n_object> ();
+      items.reserve (e.size ());
+      std::unordered_set <std::string_view> names;
+      for (std::size_t i = 0; i < e.size (); ++i)
+      {
+        auto name = e.key (i);
+        bool duplicate = false;
+        if (e.size () <= 16)
+          for (std::size_t j = 0; j < i && ! duplicate; ++j)
+            duplicate = e.key (j) == name;
+        else
+          duplicate = ! names.insert (name).second;
+
+        if (! duplicate)
+          items.emplace_back (json::decode (std::string (name)), node (e[i]));
+      }
+    }
+    break;
+
+  case j_value:
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accepts and rejects exactly what json::parse does, with the same errors.
+json::node json::node::parse (const std::string& input)
+{
+  document doc (input);
+  return node (doc.root ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node json::node::clone () const
+{
+  node copy;
+  switch (_data.index ())
+  {
+  case n_array:
+    copy._data.emplace <n_array> ().reserve (size ());
+    for (auto& item : std::get <n_array> (_data))
+      copy.push_back (item.clone ());
+    break;
+
+  case n_object:
+    copy._data.emplace <n_object> ().reserve (size ());
+    for (auto& item : std::get <n_object> (_data))
+      std::get <n_object> (copy._data).emplace_back (item.first, item.second.clone ());
+    break;
+
+  case n_bool:   copy._data.emplace <n_bool>   (std::get <n_bool>   (_data)); break;
+  case n_int:    copy._data.emplace <n_int>    (std::get <n_int>    (_data)); break;
+  case n_uint:   copy._data.emplace <n_uint>   (std::get <n_uint>   (_data)); break;
+  case n_real:   copy._data.emplace <n_real>   (std::get <n_real>   (_data)); break;
+  case n_string: copy._data.emplace <n_string> (std::get <n_string> (_data)); break;
+  }
+
+  return copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::jtype json::node::type () const
+{
+  switch (_data.index ())
+  {
+  case n_null:
+  case n_bool:   return j_literal;
+  case n_int:
+  case n_uint:
+  case n_real:   return j_number;
+  case n_string: return j_string;
+  case n_array:  return j_array;
+  case n_object: return j_object;
+  }
+
+  return j_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string json::node::dump () const
+{
+  std::string output;
+  Writer writer (output);
+  write (writer);
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::node::write (Writer& writer) const
+{
+  switch (_data.index ())
+  {
+  case n_null:   writer.null ();                           break;
+  case n_bool:   writer.value (std::get <n_bool>   (_data)); break;
+  case n_int:    writer.value (std::get <n_int>    (_data)); break;
+  case n_uint:   writer.value (std::get <n_uint>   (_data)); break;
+  case n_real:   writer.value (std::get <n_real>   (_data)); break;
+  case n_string: writer.value (std::string_view (std::get <n_string> (_data))); break;
+
+  case n_array:
+    writer.beginArray ();
+    for (auto& item : std::get <n_array> (_data))
+      item.write (writer);
+
+    writer.endArray ();
+    break;
+
+  case n_object:
+    writer.beginObject ();
+    for (auto& item : std::get <n_object> (_data))
+    {
+      writer.key (item.first);
+      item.second.write (writer);
+    }
+
+    writer.endObject ();
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string_view json::node::str () const
+{
+  auto s = std::get_if <n_string> (&_data);
+  return s ? std::string_view (*s) : std::string_view ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double json::node::number () const
+{
+  switch (_data.index ())
+  {
+  case n_int:  return (double) std::get <n_int> (_data);
+  case n_uint: return (double) std::get <n_uint> (_data);
+  case n_real: return std::get <n_real> (_data);
+  }
+
+  return 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::number::number_kind json::node::kind () const
+{
+       if (_data.index () == n_int)  return json::number::intvalue;
+  else if (_data.index () == n_uint) return json::number::uintvalue;
+  else                               return json::number::realvalue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int64_t json::node::ivalue () const
+{
+  auto i = std::get_if <n_int> (&_data);
+  return i ? *i : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t json::node::uvalue () const
+{
+  auto u = std::get_if <n_uint> (&_data);
+  return u ? *u : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::literal::literal_value json::node::lvalue () const
+{
+  if (_data.index () == n_null)
+    return literal::nullvalue;
+
+  auto b = std::get_if <n_bool> (&_data);
+  if (b)
+    return *b ? literal::truevalue : literal::falsevalue;
+
+  return literal::none;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t json::node::size () const
+{
+       if (auto a = std::get_if <n_array>  (&_data)) return a->size ();
+  else if (auto o = std::get_if <n_object> (&_data)) return o->size ();
+  else                                              return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node& json::node::operator[] (std::size_t index)
+{
+  return const_cast <node&> (static_cast <const node&> (*this)[index]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const json::node& json::node::operator[] (std::size_t index) const
+{
+  if (index >= size ())
+    throw format ("Error: node index {1} out of range", (int) index);
+
+  if (auto a = std::get_if <n_array> (&_data))
+    return (*a)[index];
+
+  return std::get <n_object> (_data)[index].second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string_view json::node::key (std::size_t index) const
+{
+  auto o = std::get_if <n_object> (&_data);
+  if (! o || index >= o->size ())
+    throw format ("Error: node index {1} out of range", (int) index);
+
+  return (*o)[index].first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node* json::node::find (std::string_view name)
+{
+  return const_cast <node*> (static_cast <const node&> (*this).find (name));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Linear, as for json::element.
+const json::node* json::node::find (std::string_view name) const
+{
+  if (auto o = std::get_if <n_object> (&_data))
+    for (auto& item : *o)
+      if (item.first == name)
+        return &item.second;
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node& json::node::push_back (node&& item)
+{
+  auto& items = as_array ();
+  items.push_back (std::move (item));
+  return items.back ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node& json::node::set (std::string_view name, node&& item)
+{
+  if (auto existing = find (name))
+    return *existing = std::move (item);
+
+  auto& items = as_object ();
+  items.emplace_back (std::string (name), std::move (item));
+  return items.back ().second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node json::node::take (std::size_t index)
+{
+  node taken = std::move ((*this)[index]);
+  if (auto a = std::get_if <n_array> (&_data))
+    a->erase (a->begin () + index);
+  else
+    std::get <n_object> (_data).erase (std::get <n_object> (_data).begin () + index);
+
+  return taken;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node json::node::take (std::string_view name)
+{
+  auto& items = as_object ();
+  auto found = std::find_if (items.begin (), items.end (),
+                             [name] (const auto& item) { return item.first == name; });
+  if (found == items.end ())
+    throw format ("Error: node has no member '{1}'", std::string (name));
+
+  node taken = std::move (found->second);
+  items.erase (found);
+  return taken;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::node::reserve (std::size_t count)
+{
+  if (_data.index () == n_object)
+    as_object ().reserve (count);
+  else
+    as_array ().reserve (count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::array_type& json::node::as_array ()
+{
+  auto a = std::get_if <n_array> (&_data);
+  if (! a)
+    throw format ("Error: node of type {1} is not an array", (int) type ());
+
+  return *a;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::node::object_type& json::node::as_object ()
+{
+  auto o = std::get_if <n_object> (&_data);
+  if (! o)
+    throw format ("Error: node of type {1} is not an object", (int) type ());
+
+  return *o;
+}
+
+////////////////////////////////////////////////////////////////////////////////
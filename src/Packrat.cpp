@@ -50,7 +50,7 @@ void Packrat::parse (const PEG& peg, const std::string& input)
   _tree->_name = peg.firstRule ();
 
   // The pig that will be sent down the pipe.
-  Pig pig (input);
+  Pig pig {std::string_view (input)};
   if (_debug)
     std::cout << "trace " << pig.dump () << "\n";
 
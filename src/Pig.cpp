@@ -28,21 +28,39 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstdlib>
+#include <scan.h>
 #include <shared.h>
 #include <sstream>
 #include <unicode.h>
 #include <utf8.h>
 
 ////////////////////////////////////////////////////////////////////////////////
+// Takes a private copy of the text, which is shared between copies of the Pig.
 Pig::Pig (const std::string& text)
-: _text {std::make_shared <std::string> (text)}
+: _owned {std::make_shared <std::string> (text)}
+, _text  {*_owned}
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pig::Pig (const char* text)
+: _owned {std::make_shared <std::string> (text)}
+, _text  {*_owned}
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Borrows the text without copying it.  The caller must keep the underlying
+// buffer alive, and unmodified, for the lifetime of the Pig.
+Pig::Pig (std::string_view text)
+: _text {text}
 {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::skip (int c)
 {
-  if ((*_text)[_cursor] == c)
+  if (at (_cursor) == c)
   {
     ++_cursor;
     return true;
@@ -56,14 +74,27 @@ bool Pig::skipN (const int quantity)
 {
   auto save = _cursor;
 
-  auto count = 0;
-  while (count++ < quantity)
+  std::string::size_type target = quantity > 0 ? quantity : 0;
+  std::string::size_type count = 0;
+  while (count < target)
   {
-    if (! utf8_next_char (*_text, _cursor))
+    // A run of ASCII characters is advanced over in one step.
+    if (at (_cursor) > 0)
+    {
+      auto run = scan_ascii (_text.data () + _cursor,
+                             std::min (remaining (), target - count));
+      _cursor += run;
+      count += run;
+      continue;
+    }
+
+    if (! utf8_next_char (_text, _cursor))
     {
       _cursor = save;
       return false;
     }
+
+    ++count;
   }
 
   return true;
@@ -74,9 +105,13 @@ bool Pig::skipWS ()
 {
   auto save = _cursor;
 
+  // Bulk-skip ASCII whitespace, leaving any Unicode whitespace that follows to
+  // the loop below.
+  _cursor += scan_ascii_space (_text.data () + _cursor, remaining ());
+
   int c;
   auto prev = _cursor;
-  while ((c = utf8_next_char (*_text, _cursor)))
+  while ((c = utf8_next_char (_text, _cursor)))
   {
     if (! unicodeWhitespace (c))
     {
@@ -92,7 +127,7 @@ bool Pig::skipWS ()
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::skipLiteral (const std::string& literal)
 {
-  if (_text->find (literal, _cursor) == _cursor)
+  if (_text.find (literal, _cursor) == _cursor)
   {
     _cursor += literal.length ();
     return true;
@@ -108,14 +143,14 @@ bool Pig::skipPartial (const std::string& reference, std::string& result,
   // Walk the common substring.
   auto pos = 0;
   while (reference[pos] &&
-         (*_text)[_cursor + pos] &&
-         ((reference[pos] == (*_text)[_cursor + pos] && !ignore_case) ||
-          (reference[pos] == tolower((*_text)[_cursor + pos]) && ignore_case)))
+         at (_cursor + pos) &&
+         ((reference[pos] == at (_cursor + pos) && !ignore_case) ||
+          (reference[pos] == tolower(at (_cursor + pos)) && ignore_case)))
     ++pos;
 
   if (pos > 0)
   {
-    result = _text->substr (_cursor, pos);
+    result = _text.substr (_cursor, pos);
     _cursor += pos;
     return true;
   }
@@ -129,17 +164,17 @@ bool Pig::skipPartial (const std::string& reference, std::string& result,
 bool Pig::getUntilAscii (char end, std::string& result)
 {
   auto save = _cursor;
-  auto found = _text->find (end, _cursor + 1);
+  auto found = _text.find (end, _cursor + 1);
 
   if (found == std::string::npos)
   {
-    found = _text->size ();
-    result = _text->substr (_cursor, found - _cursor);
+    found = _text.size ();
+    result = _text.substr (_cursor, found - _cursor);
     _cursor = found;
     return true;
   }
 
-  result = _text->substr (_cursor, found - _cursor);
+  result = _text.substr (_cursor, found - _cursor);
   _cursor = _cursor + result.size();
 
   return _cursor > save;
@@ -152,18 +187,18 @@ bool Pig::getUntil (int end, std::string& result)
 
   int c;
   auto prev = _cursor;
-  while ((c = utf8_next_char (*_text, _cursor)))
+  while ((c = utf8_next_char (_text, _cursor)))
   {
     if (c == end)
     {
       _cursor = prev;
-      result = _text->substr (save, _cursor - save);
+      result = _text.substr (save, _cursor - save);
       return true;
     }
 
     else if (eos ())
     {
-      result = _text->substr (save, _cursor - save);
+      result = _text.substr (save, _cursor - save);
       return true;
     }
 
@@ -178,14 +213,20 @@ bool Pig::getUntilWS (std::string& result)
 {
   auto save = _cursor;
 
+  // Bulk-skip plain ASCII characters, but leave the last of them for the loop
+  // below, so that it sees the end of the run exactly as it would otherwise.
+  auto run = scan_ascii_nonspace (_text.data () + _cursor, remaining ());
+  if (run > 1)
+    _cursor += run - 1;
+
   int c;
   auto prev = _cursor;
-  while ((c = utf8_next_char (*_text, _cursor)))
+  while ((c = utf8_next_char (_text, _cursor)))
   {
     if (unicodeWhitespace (c))
     {
       _cursor = prev;
-      result = _text->substr (save, _cursor - save);
+      result = _text.substr (save, _cursor - save);
       return true;
     }
 
@@ -194,7 +235,7 @@ bool Pig::getUntilWS (std::string& result)
     //       which has already been advanced.
     else if (eos ())
     {
-      result = _text->substr (save, _cursor - save);
+      result = _text.substr (save, _cursor - save);
       return true;
     }
 
@@ -207,7 +248,7 @@ bool Pig::getUntilWS (std::string& result)
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::getCharacter (int& result)
 {
-  int c = (*_text)[_cursor];
+  int c = at (_cursor);
   if (c)
   {
     result = c;
@@ -221,7 +262,7 @@ bool Pig::getCharacter (int& result)
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::getDigit (int& result)
 {
-  int c = (*_text)[_cursor];
+  int c = at (_cursor);
   if (c &&
       unicodeLatinDigit (c))
   {
@@ -236,11 +277,11 @@ bool Pig::getDigit (int& result)
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::getDigit2 (int& result)
 {
-  if (unicodeLatinDigit ((*_text)[_cursor + 0]))
+  if (unicodeLatinDigit (at (_cursor + 0)))
   {
-    if (unicodeLatinDigit ((*_text)[_cursor + 1]))
+    if (unicodeLatinDigit (at (_cursor + 1)))
     {
-      result = strtoimax (_text->substr (_cursor, 2).c_str (), nullptr, 10);
+      result = (at (_cursor) - '0') * 10 + (at (_cursor + 1) - '0');
       _cursor += 2;
       return true;
     }
@@ -252,13 +293,13 @@ bool Pig::getDigit2 (int& result)
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::getDigit3 (int& result)
 {
-  if (unicodeLatinDigit ((*_text)[_cursor + 0]))
+  if (unicodeLatinDigit (at (_cursor + 0)))
   {
-    if (unicodeLatinDigit ((*_text)[_cursor + 1]))
+    if (unicodeLatinDigit (at (_cursor + 1)))
     {
-      if (unicodeLatinDigit ((*_text)[_cursor + 2]))
+      if (unicodeLatinDigit (at (_cursor + 2)))
       {
-        result = strtoimax (_text->substr (_cursor, 3).c_str (), nullptr, 10);
+        result = (at (_cursor) - '0') * 100 + (at (_cursor + 1) - '0') * 10 + (at (_cursor + 2) - '0');
         _cursor += 3;
         return true;
       }
@@ -271,15 +312,16 @@ bool Pig::getDigit3 (int& result)
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::getDigit4 (int& result)
 {
-  if (unicodeLatinDigit ((*_text)[_cursor + 0]))
+  if (unicodeLatinDigit (at (_cursor + 0)))
   {
-    if (unicodeLatinDigit ((*_text)[_cursor + 1]))
+    if (unicodeLatinDigit (at (_cursor + 1)))
     {
-      if (unicodeLatinDigit ((*_text)[_cursor + 2]))
+      if (unicodeLatinDigit (at (_cursor + 2)))
       {
-        if (unicodeLatinDigit ((*_text)[_cursor + 3]))
+        if (unicodeLatinDigit (at (_cursor + 3)))
         {
-          result = strtoimax (_text->substr (_cursor, 4).c_str (), nullptr, 10);
+          result = (at (_cursor) - '0') * 1000 + (at (_cursor + 1) - '0') * 100 +
+                   (at (_cursor + 2) - '0') * 10   + (at (_cursor + 3) - '0');
           _cursor += 4;
           return true;
         }
@@ -307,10 +349,11 @@ bool Pig::getDigits (int& result)
 bool Pig::getDigits (long long& result)
 {
   auto save = _cursor;
+  _cursor += scan_ascii_digit (_text.data () + _cursor, remaining ());
 
   int c;
   auto prev = _cursor;
-  while ((c = utf8_next_char (*_text, _cursor)))
+  while ((c = utf8_next_char (_text, _cursor)))
   {
     if (! unicodeLatinDigit (c))
     {
@@ -323,7 +366,7 @@ bool Pig::getDigits (long long& result)
 
   if (_cursor > save)
   {
-    result = strtoimax (_text->substr (save, _cursor - save).c_str (), nullptr, 10);
+    result = strtoimax (std::string (_text.substr (save, _cursor - save)).c_str (), nullptr, 10);
     return true;
   }
 
@@ -333,7 +376,7 @@ bool Pig::getDigits (long long& result)
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::getHexDigit (int& result)
 {
-  int c = (*_text)[_cursor];
+  int c = at (_cursor);
   if (c &&
       unicodeHexDigit (c))
   {
@@ -377,53 +420,67 @@ bool Pig::getHexDigit (int& result)
 //   e|E (+|-)?
 //
 bool Pig::getNumber (std::string& result)
+{
+  std::string_view number;
+  if (getNumber (number))
+  {
+    result.assign (number.data (), number.length ());
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// As above, but the result refers to the text, without copying it.
+bool Pig::getNumber (std::string_view& result)
 {
   auto i = _cursor;
 
   // [+-]?
-  if ((*_text)[i] &&
-      ((*_text)[i] == '-' ||
-       (*_text)[i] == '+'))
+  if (at (i) &&
+      (at (i) == '-' ||
+       at (i) == '+'))
     ++i;
 
   // digit+
-  if ((*_text)[i] &&
-      unicodeLatinDigit ((*_text)[i]))
+  if (at (i) &&
+      unicodeLatinDigit (at (i)))
   {
     ++i;
 
-    while ((*_text)[i] && unicodeLatinDigit ((*_text)[i]))
+    while (at (i) && unicodeLatinDigit (at (i)))
       ++i;
 
     // ( . digit+ )?
-    if ((*_text)[i] && (*_text)[i] == '.')
+    if (at (i) && at (i) == '.')
     {
       ++i;
 
-      while ((*_text)[i] && unicodeLatinDigit ((*_text)[i]))
+      while (at (i) && unicodeLatinDigit (at (i)))
         ++i;
     }
 
     // ( [eE] [+-]? digit+ )?
-    if ((*_text)[i] &&
-        ((*_text)[i] == 'e' ||
-         (*_text)[i] == 'E'))
+    if (at (i) &&
+        (at (i) == 'e' ||
+         at (i) == 'E'))
     {
       ++i;
 
-      if ((*_text)[i] &&
-          ((*_text)[i] == '+' ||
-           (*_text)[i] == '-'))
+      if (at (i) &&
+          (at (i) == '+' ||
+           at (i) == '-'))
         ++i;
 
-      if ((*_text)[i] && unicodeLatinDigit ((*_text)[i]))
+      if (at (i) && unicodeLatinDigit (at (i)))
       {
         ++i;
 
-        while ((*_text)[i] && unicodeLatinDigit ((*_text)[i]))
+        while (at (i) && unicodeLatinDigit (at (i)))
           ++i;
 
-        result = _text->substr (_cursor, i - _cursor);
+        result = _text.substr (_cursor, i - _cursor);
         _cursor = i;
         return true;
       }
@@ -431,7 +488,7 @@ bool Pig::getNumber (std::string& result)
       return false;
     }
 
-    result = _text->substr (_cursor, i - _cursor);
+    result = _text.substr (_cursor, i - _cursor);
     _cursor = i;
     return true;
   }
@@ -442,10 +499,10 @@ bool Pig::getNumber (std::string& result)
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::getNumber (double& result)
 {
-  std::string s;
-  if (getNumber (s))
+  std::string_view number;
+  if (getNumber (number))
   {
-    result = std::strtod (s.c_str (), nullptr);
+    parseDouble (number, result);
     return true;
   }
 
@@ -459,29 +516,29 @@ bool Pig::getDecimal (std::string& result)
   auto i = _cursor;
 
   // [+-]?
-  if ((*_text)[i] &&
-      ((*_text)[i] == '-' ||
-       (*_text)[i] == '+'))
+  if (at (i) &&
+      (at (i) == '-' ||
+       at (i) == '+'))
     ++i;
 
   // digit+
-  if ((*_text)[i] && unicodeLatinDigit ((*_text)[i]))
+  if (at (i) && unicodeLatinDigit (at (i)))
   {
     ++i;
 
-    while ((*_text)[i] && unicodeLatinDigit ((*_text)[i]))
+    while (at (i) && unicodeLatinDigit (at (i)))
       ++i;
 
     // ( . digit+ )?
-    if ((*_text)[i] && (*_text)[i] == '.')
+    if (at (i) && at (i) == '.')
     {
       ++i;
 
-      while ((*_text)[i] && unicodeLatinDigit ((*_text)[i]))
+      while (at (i) && unicodeLatinDigit (at (i)))
         ++i;
     }
 
-    result = _text->substr (_cursor, i - _cursor);
+    result = _text.substr (_cursor, i - _cursor);
     _cursor = i;
     return true;
   }
@@ -509,56 +566,48 @@ bool Pig::getDecimal (double& result)
 // Does not modify content between quotes.
 bool Pig::getQuoted (int quote, std::string& result)
 {
-  if (! (*_text)[_cursor] ||
-      (*_text)[_cursor] != quote)
+  std::string_view content;
+  if (getQuoted (quote, content))
+  {
+    result.assign (content.data (), content.length ());
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// As above, but the result refers to the text, without copying it.
+bool Pig::getQuoted (int quote, std::string_view& result)
+{
+  if (! at (_cursor) ||
+      at (_cursor) != quote)
     return false;
 
   auto start = _cursor + utf8_sequence (quote);
   auto i = start;
 
-  while ((*_text)[i])
+  // Walk forward between quote and backslash positions.  A backslash escapes
+  // the following character, so pairs of backslashes cancel out, and only an
+  // unescaped quote closes the string.
+  while (i < _text.length ())
   {
-    i = _text->find (quote, i);
-    if (i == std::string::npos)
-      return false;  // Unclosed quote. Shortcut, not definitive.
-
-    if (i == start)
-    {
-      // Empty quote
-      _cursor += 2 * utf8_sequence (quote);  // Skip both quote chars
-      result = "";
-      return true;
-    }
+    i += scan_until (_text.data () + i, _text.length () - i, quote, '\\');
+    if (i >= _text.length ())
+      break;
 
-    if ((*_text)[i - 1] == '\\')
+    if (_text[i] == '\\')
     {
-      // Check for escaped backslashes.  Backtracking like this is not very
-      // efficient, but is only done in extreme corner cases.
-
-      auto j = i - 2;  // Start one character further left
-      bool is_escaped_quote = true;
-      while (j >= start && (*_text)[j] == '\\')
-      {
-        // Toggle flag for each further backslash encountered.
-        is_escaped_quote = !is_escaped_quote;
-        --j;
-      }
-
-      if (is_escaped_quote)
-      {
-        // Keep searching
-        ++i;
-        continue;
-      }
+      i += 2;
+      continue;
     }
 
-    // None of the above applied, we must have found the closing quote char.
-    result.assign (*_text, start, i - start);
+    result = _text.substr (start, i - start);
     _cursor = i + utf8_sequence (quote);  // Skip closing quote char
     return true;
   }
 
-  // This should never be reached.  We could throw here instead.
+  // Unclosed quote.
   return false;
 }
 
@@ -606,9 +655,9 @@ bool Pig::getHMS (int& hours, int& minutes, int& seconds)
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::getRemainder (std::string& result)
 {
-  if ((*_text)[_cursor])
+  if (at (_cursor))
   {
-    result = _text->substr (_cursor);
+    result = _text.substr (_cursor);
     _cursor += result.length ();
     return true;
   }
@@ -619,23 +668,23 @@ bool Pig::getRemainder (std::string& result)
 ////////////////////////////////////////////////////////////////////////////////
 bool Pig::eos () const
 {
-  return (*_text)[_cursor] == '\0';
+  return at (_cursor) == '\0';
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Peeks ahead - does not move cursor.
 int Pig::peek () const
 {
-  return (*_text)[_cursor];
+  return at (_cursor);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Peeks ahead - does not move cursor.
 std::string Pig::peek (const int quantity) const
 {
-  std::string::size_type adjusted = std::min (static_cast <std::string::size_type> (quantity), _text->length () - _cursor);
-  if ((*_text)[_cursor])
-    return _text->substr (_cursor, adjusted);
+  std::string::size_type adjusted = std::min (static_cast <std::string::size_type> (quantity), _text.length () - _cursor);
+  if (at (_cursor))
+    return std::string (_text.substr (_cursor, adjusted));
 
   return "";
 }
@@ -666,18 +715,46 @@ std::string::size_type Pig::restoreTo (std::string::size_type previous)
   return _cursor = previous;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Moves the cursor directly to a byte offset, unlike skipN, which walks
+// characters from the cursor.  An offset beyond the end of the text is
+// rejected, leaving the cursor unmoved.
+bool Pig::seek (std::string::size_type offset)
+{
+  if (offset > _text.length ())
+    return false;
+
+  _cursor = offset;
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string Pig::substr (
   std::string::size_type start,
   std::string::size_type end) const
 {
-  return _text->substr (start, end - start);
+  return std::string (_text.substr (start, end - start));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string Pig::str () const
 {
-  return _text->substr (_cursor);
+  return std::string (_text.substr (_cursor));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Number of bytes from the cursor to the end of the text.
+std::string::size_type Pig::remaining () const
+{
+  return _cursor < _text.length () ? _text.length () - _cursor : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads past the end of the text yield NUL, as they would for a std::string,
+// which allows the scanning methods to treat both modes identically.
+char Pig::at (std::string::size_type index) const
+{
+  return index < _text.size () ? _text[index] : '\0';
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -688,15 +765,15 @@ std::string Pig::dump () const
   std::stringstream out;
   if (_cursor)
     out << "[37;42m"
-        << _text->substr (0, _cursor)
+        << _text.substr (0, _cursor)
         << "[0m";
 
   out << "[37;41m"
-      << _text->substr (_cursor)
+      << _text.substr (_cursor)
       << "[0m "
       << _cursor
       << '/'
-      << _text->length ();
+      << _text.length ();
 
   return str_replace (out.str (), "\n", "\\n");
 }
@@ -29,12 +29,15 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Pig
 {
 public:
   explicit Pig (const std::string&);
+  explicit Pig (const char*);
+  explicit Pig (std::string_view);
 
   bool skip (int);
   bool skipN (const int quantity = 1);
@@ -54,10 +57,12 @@ public:
   bool getDigits (long long&);
   bool getHexDigit (int&);
   bool getNumber (std::string&);
+  bool getNumber (std::string_view&);
   bool getNumber (double&);
   bool getDecimal (std::string&);
   bool getDecimal (double&);
   bool getQuoted (int, std::string&);
+  bool getQuoted (int, std::string_view&);
   bool getOneOf (const std::vector <std::string>&, std::string&);
   bool getHMS (int&, int&, int&);
   bool getRemainder (std::string&);
@@ -69,13 +74,19 @@ public:
   std::string::size_type save ();
   std::string::size_type restore ();
   std::string::size_type restoreTo (std::string::size_type);
+  bool seek (std::string::size_type);
 
   std::string substr (std::string::size_type, std::string::size_type) const;
   std::string str () const;
   std::string dump () const;
 
 private:
-  std::shared_ptr<std::string> _text;
+  char at (std::string::size_type) const;
+  std::string::size_type remaining () const;
+
+private:
+  std::shared_ptr<std::string> _owned;
+  std::string_view             _text;
   std::string::size_type       _cursor {0};
   std::string::size_type       _saved  {0};
 };
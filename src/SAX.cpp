@@ -25,13 +25,80 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <JSON.h>
-#include <cerrno>
 #include <cstdlib>
+#include <cstring>
+#include <scan.h>
 #include <sstream>
 #include <utf8.h>
 
+namespace
+{
+  // Passes on events after skipping a number of them.
+  class ResumeSink : public json::SAX::ViewSink
+  {
+  public:
+    ResumeSink (json::SAX::ViewSink& sink, std::size_t skip) : _sink (sink), _skip (skip) {}
+    void eventDocStart () override                          { if (pass ()) _sink.eventDocStart ();          }
+    void eventDocEnd () override                            { if (pass ()) _sink.eventDocEnd ();            }
+    void eventObjectStart () override                       { if (pass ()) _sink.eventObjectStart ();       }
+    void eventObjectEnd (int count) override                { if (pass ()) _sink.eventObjectEnd (count);    }
+    void eventArrayStart () override                        { if (pass ()) _sink.eventArrayStart ();        }
+    void eventArrayEnd (int count) override                 { if (pass ()) _sink.eventArrayEnd (count);     }
+    void eventName (std::string_view value) override        { if (pass ()) _sink.eventName (value);         }
+    void eventValueNull () override                         { if (pass ()) _sink.eventValueNull ();         }
+    void eventValueBool (bool value) override               { if (pass ()) _sink.eventValueBool (value);    }
+    void eventValueInt (int64_t value) override             { if (pass ()) _sink.eventValueInt (value);     }
+    void eventValueUint (uint64_t value) override           { if (pass ()) _sink.eventValueUint (value);    }
+    void eventValueDouble (double value) override           { if (pass ()) _sink.eventValueDouble (value);  }
+    void eventValueString (std::string_view value) override { if (pass ()) _sink.eventValueString (value);  }
+
+  private:
+    bool pass ()
+    {
+      if (_skip == 0)
+        return true;
+
+      --_skip;
+      return false;
+    }
+
+    json::SAX::ViewSink& _sink;
+    std::size_t          _skip;
+  };
+
+  // Presents a classic Sink as a ViewSink, copying views into strings.
+  class SinkAdapter : public json::SAX::ViewSink
+  {
+  public:
+    explicit SinkAdapter (json::SAX::Sink& sink) : _sink (sink) {}
+    void eventDocStart () override                    { _sink.eventDocStart ();                         }
+    void eventDocEnd () override                      { _sink.eventDocEnd ();                           }
+    void eventObjectStart () override                 { _sink.eventObjectStart ();                      }
+    void eventObjectEnd (int count) override          { _sink.eventObjectEnd (count);                   }
+    void eventArrayStart () override                  { _sink.eventArrayStart ();                       }
+    void eventArrayEnd (int count) override           { _sink.eventArrayEnd (count);                    }
+    void eventName (std::string_view value) override  { _sink.eventName (std::string (value));          }
+    void eventValueNull () override                   { _sink.eventValueNull ();                        }
+    void eventValueBool (bool value) override         { _sink.eventValueBool (value);                   }
+    void eventValueInt (int64_t value) override       { _sink.eventValueInt (value);                    }
+    void eventValueUint (uint64_t value) override     { _sink.eventValueUint (value);                   }
+    void eventValueDouble (double value) override     { _sink.eventValueDouble (value);                 }
+    void eventValueString (std::string_view value) override { _sink.eventValueString (std::string (value)); }
+
+  private:
+    json::SAX::Sink& _sink;
+  };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool json::SAX::parse (const std::string& input, SAX::Sink& sink)
+{
+  SinkAdapter adapter (sink);
+  return parse (input, adapter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool json::SAX::parse (const std::string& input, SAX::ViewSink& sink)
 {
   sink.eventDocStart ();
   std::string::size_type cursor = 0;
@@ -51,6 +118,307 @@ bool json::SAX::parse (const std::string& input, SAX::Sink& sink)
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool json::SAX::parseIndexed (const std::string& input, SAX::Sink& sink)
+{
+  SinkAdapter adapter (sink);
+  return parseIndexed (input, adapter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Should the second stage meet anything it does not handle, which includes
+// every error, the document is parsed again by the character parser, with the
+// events already sent suppressed.  That parser then either continues where the
+// second stage stopped, or raises the error it would have raised.
+bool json::SAX::parseIndexed (const std::string& input, SAX::ViewSink& sink)
+{
+  // Index offsets are 32 bits.
+  if (input.length () > UINT32_MAX)
+    return parse (input, sink);
+
+  _index.clear ();
+  _special = scan_json_structure (input.data (), input.length (), _index);
+
+  std::size_t events = 0;
+  _indexed = true;
+  try
+  {
+    if (isIndexedDocument (input, sink, events))
+    {
+      _indexed = false;
+      return true;
+    }
+  }
+
+  catch (...)
+  {
+    _indexed = false;
+    throw;
+  }
+
+  _indexed = false;
+  ResumeSink resume (sink, events);
+  return parse (input, resume);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The second stage.  Structure is handled here, token by token from the
+// index, and each scalar by the same functions that parse uses.  Returns
+// false, having sent the number of events so far, at the first token that
+// does not fit.
+bool json::SAX::isIndexedDocument (const std::string& input, SAX::ViewSink& sink, std::size_t& events)
+{
+  enum class expect {root, value, member, element, colon, separator, done};
+
+  _open.clear ();
+  _counts.clear ();
+
+  sink.eventDocStart ();
+  ++events;
+
+  auto state = expect::root;
+  std::size_t i = 0;
+  while (i < _index.size ())
+  {
+    std::string::size_type cursor = _index[i];
+    char c = input[cursor];
+
+    // Closing a container, or completing a scalar, ends a value.
+    bool ended = false;
+    if ((c == '}' && (state == expect::member || (state == expect::separator && _open.back () == '{'))) ||
+        (c == ']' && (state == expect::element || (state == expect::separator && _open.back () == '['))))
+    {
+      if (c == '}')
+        sink.eventObjectEnd (_counts.back ());
+      else
+        sink.eventArrayEnd (_counts.back ());
+
+      ++events;
+      _open.pop_back ();
+      _counts.pop_back ();
+      ++i;
+      ended = true;
+    }
+    else if (state == expect::member)
+    {
+      std::string_view name;
+      if (c == '"' && isIndexedString (input, i, name))
+      {
+        sink.eventName (name);
+        i += 2;
+      }
+      else
+      {
+        _next = i;
+        if (! isKey (input, cursor, sink))
+          return false;
+
+        if (! nextIndexed (input, cursor, i))
+        {
+          ++events;
+          return false;
+        }
+      }
+
+      ++events;
+      state = expect::colon;
+    }
+    else if (state == expect::colon || state == expect::separator)
+    {
+      if (c != (state == expect::colon ? ':' : ','))
+        return false;
+
+      state = state == expect::colon  ? expect::value
+            : _open.back () == '{'    ? expect::member
+            :                           expect::element;
+      ++i;
+    }
+    else if (c == '{' || c == '[')
+    {
+      if (state == expect::done)
+        return false;
+
+      if (c == '{')
+        sink.eventObjectStart ();
+      else
+        sink.eventArrayStart ();
+
+      ++events;
+      _open.push_back (c);
+      _counts.push_back (0);
+      state = c == '{' ? expect::member : expect::element;
+      ++i;
+    }
+    else
+    {
+      if (state == expect::root || state == expect::done)
+        return false;
+
+      std::string_view value;
+      if (c == '"' && isIndexedString (input, i, value))
+      {
+        sink.eventValueString (value);
+        i += 2;
+      }
+      else if ((c == '-' || (c >= '0' && c <= '9')) && isIndexedNumber (input, i, sink))
+        ++i;
+      else
+      {
+        _next = i;
+        if (! isString (input, cursor, sink) &&
+            ! isNumber (input, cursor, sink) &&
+            ! isBool   (input, cursor, sink) &&
+            ! isNull   (input, cursor, sink))
+          return false;
+
+        // The value was sent, but what follows it needs the character parser.
+        if (! nextIndexed (input, cursor, i))
+        {
+          ++events;
+          return false;
+        }
+      }
+
+      ++events;
+      ended = true;
+    }
+
+    if (ended)
+    {
+      if (_open.empty ())
+        state = expect::done;
+      else
+      {
+        ++_counts.back ();
+        state = expect::separator;
+      }
+    }
+  }
+
+  if (state != expect::done)
+    return false;
+
+  sink.eventDocEnd ();
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A string at index entry i, closed by entry i + 1, without escapes or NUL, is
+// viewed directly.  Anything else is left to isStringValue.
+bool json::SAX::isIndexedString (const std::string& input, std::size_t i, std::string_view& value)
+{
+  if (i + 1 >= _index.size () ||
+      input[_index[i + 1]] != '"')
+    return false;
+
+  auto start = _index[i] + 1;
+  auto length = _index[i + 1] - start;
+  if (_special &&
+      scan_until (input.data () + start, length, '\\', '\0') != length)
+    return false;
+
+  value = std::string_view (input.data () + start, length);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A number at index entry i, which is followed directly by the next token or
+// by whitespace, is converted without copies.  Integers short enough not to
+// overflow are accumulated, and others converted as SAX::number would.
+// Anything else is left to isNumber.
+bool json::SAX::isIndexedNumber (const std::string& input, std::size_t i, SAX::ViewSink& sink)
+{
+  auto start = _index[i];
+  auto cursor = start + (input[start] == '-' ? 1 : 0);
+  auto digits = scan_ascii_digit (input.data () + cursor, input.length () - cursor);
+  if (digits == 0)
+    return false;
+
+  cursor += digits;
+  bool integer = true;
+  if (input[cursor] == '.')
+  {
+    auto fraction = scan_ascii_digit (input.data () + cursor + 1, input.length () - cursor - 1);
+    if (fraction == 0)
+      return false;
+
+    cursor += 1 + fraction;
+    integer = false;
+  }
+
+  if (input[cursor] == 'e' || input[cursor] == 'E')
+  {
+    auto exponent = cursor + 1;
+    if (input[exponent] == '+' || input[exponent] == '-')
+      ++exponent;
+
+    auto count = scan_ascii_digit (input.data () + exponent, input.length () - exponent);
+    if (count == 0)
+      return false;
+
+    cursor = exponent + count;
+    integer = false;
+  }
+
+  // isFrac allows whitespace before the '.', so an integer followed by
+  // whitespace and then a '.' is not complete.
+  char c = input[cursor];
+  if (c == ' ' || (c >= '\t' && c <= '\r'))
+  {
+    if (integer && i + 1 < _index.size () && input[_index[i + 1]] == '.')
+      return false;
+  }
+  else if (i + 1 >= _index.size () || _index[i + 1] != cursor)
+    return false;
+
+  if (integer && digits <= 18)
+  {
+    int64_t value = 0;
+    for (auto p = cursor - digits; p < cursor; ++p)
+      value = value * 10 + (input[p] - '0');
+
+    sink.eventValueInt (input[start] == '-' ? -value : value);
+    return true;
+  }
+
+  return number (std::string_view (input.data () + start, cursor - start), sink);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Finds the index entry of the token that follows a scalar ending at cursor.
+// Returns false if there is none, because the scalar is followed by more
+// non-whitespace.
+bool json::SAX::nextIndexed (const std::string& input, std::string::size_type cursor, std::size_t& i)
+{
+  if (cursor >= input.length ())
+  {
+    i = _index.size ();
+    return true;
+  }
+
+  char c = input[cursor];
+  bool space = c == ' ' || (c >= '\t' && c <= '\r');
+
+  while (i < _index.size () && _index[i] < cursor)
+    ++i;
+
+  return space || (i < _index.size () && _index[i] == cursor);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The offset of the first token after cursor, or the end of the input.  The
+// parser backtracks a little at times, so the search may go either way.
+std::string::size_type json::SAX::nextToken (const std::string& input, std::string::size_type cursor)
+{
+  while (_next > 0 && _index[_next - 1] > cursor)
+    --_next;
+
+  while (_next < _index.size () && _index[_next] <= cursor)
+    ++_next;
+
+  return _next < _index.size () ? _index[_next] : input.length ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Complete Unicode whitespace list.
 //
@@ -96,7 +464,7 @@ void json::SAX::ignoreWhitespace (const std::string& input, std::string::size_ty
 
 ////////////////////////////////////////////////////////////////////////////////
 // object := '{' [<pair> [, <pair> ...]] '}'
-bool json::SAX::isObject (const std::string& input, std::string::size_type& cursor, SAX::Sink& sink)
+bool json::SAX::isObject (const std::string& input, std::string::size_type& cursor, SAX::ViewSink& sink)
 {
   ignoreWhitespace (input, cursor);
   auto backup = cursor;
@@ -132,7 +500,7 @@ bool json::SAX::isObject (const std::string& input, std::string::size_type& curs
 
 ////////////////////////////////////////////////////////////////////////////////
 // array := '[' [<value> [, <value> ...]] ']'
-bool json::SAX::isArray (const std::string& input, std::string::size_type& cursor, SAX::Sink& sink)
+bool json::SAX::isArray (const std::string& input, std::string::size_type& cursor, SAX::ViewSink& sink)
 {
   ignoreWhitespace (input, cursor);
   auto backup = cursor;
@@ -168,7 +536,7 @@ bool json::SAX::isArray (const std::string& input, std::string::size_type& curso
 
 ////////////////////////////////////////////////////////////////////////////////
 // pair := <string> ':' <value>
-bool json::SAX::isPair (const std::string& input, std::string::size_type& cursor, SAX::Sink& sink)
+bool json::SAX::isPair (const std::string& input, std::string::size_type& cursor, SAX::ViewSink& sink)
 {
   ignoreWhitespace (input, cursor);
   auto backup = cursor;
@@ -198,7 +566,7 @@ bool json::SAX::isPair (const std::string& input, std::string::size_type& cursor
 //         | 'true'
 //         | 'false'
 //         | 'null'
-bool json::SAX::isValue (const std::string& input, std::string::size_type& cursor, SAX::Sink& sink)
+bool json::SAX::isValue (const std::string& input, std::string::size_type& cursor, SAX::ViewSink& sink)
 {
   ignoreWhitespace (input, cursor);
 
@@ -211,11 +579,11 @@ bool json::SAX::isValue (const std::string& input, std::string::size_type& curso
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool json::SAX::isKey (const std::string& input, std::string::size_type& cursor, SAX::Sink& sink)
+bool json::SAX::isKey (const std::string& input, std::string::size_type& cursor, SAX::ViewSink& sink)
 {
   ignoreWhitespace (input, cursor);
 
-  std::string value;
+  std::string_view value;
   if (isStringValue (input, cursor, value))
   {
     sink.eventName (value);
@@ -226,11 +594,11 @@ bool json::SAX::isKey (const std::string& input, std::string::size_type& cursor,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool json::SAX::isString (const std::string& input, std::string::size_type& cursor, SAX::Sink& sink)
+bool json::SAX::isString (const std::string& input, std::string::size_type& cursor, SAX::ViewSink& sink)
 {
   ignoreWhitespace (input, cursor);
 
-  std::string value;
+  std::string_view value;
   if (isStringValue (input, cursor, value))
   {
     sink.eventValueString (value);
@@ -252,13 +620,50 @@ bool json::SAX::isString (const std::string& input, std::string::size_type& curs
 //         | '\r'
 //         | '\t'
 //         | \uXXXX
-bool json::SAX::isStringValue (const std::string& input, std::string::size_type& cursor, std::string& value)
+//
+// Content without escapes is viewed in the input.  Otherwise it is unescaped
+// into _scratch, and the view refers to that.
+bool json::SAX::isStringValue (const std::string& input, std::string::size_type& cursor, std::string_view& value)
 {
   auto backup = cursor;
 
   if (isLiteral (input, '"', cursor))
   {
-    std::string word;
+    auto start = cursor;
+    std::string::size_type run;
+    if (_indexed)
+    {
+      // The token after an opening quote is its closing quote, unless the
+      // string is unterminated.  Escapes are found in that span.
+      auto end = nextToken (input, start - 1);
+      run = end - start;
+      if (input[end] == '"')
+      {
+        auto escape = std::memchr (input.data () + start, '\\', run);
+        if (escape)
+          run = static_cast <const char*> (escape) - (input.data () + start);
+      }
+      else
+        run = scan_until (input.data () + start, input.length () - start, '"', '\\');
+    }
+    else
+      run = scan_until (input.data () + start, input.length () - start, '"', '\\');
+
+    // An embedded NUL ends the input, as far as the string is concerned.
+    auto nul = static_cast <const char*> (std::memchr (input.data () + start, '\0', run));
+    if (nul)
+      error ("Error: Missing '\"' at position ", nul - input.data ());
+
+    cursor += run;
+    if (input[cursor] == '"')
+    {
+      ++cursor;
+      value = std::string_view (input.data () + start, run);
+      return true;
+    }
+
+    auto& word = _scratch;
+    word.assign (input, start, run);
     int c;
     while ((c = input[cursor]))
     {
@@ -287,8 +692,8 @@ bool json::SAX::isStringValue (const std::string& input, std::string::size_type&
         cursor += 6;
       }
 
-      // An escaped thing.
-      else if (c == '\\')
+      // An escaped thing.  A backslash ending the input escapes nothing.
+      else if (c == '\\' && input[cursor + 1])
       {
         c = input[++cursor];
         switch (c)
@@ -327,7 +732,7 @@ bool json::SAX::isStringValue (const std::string& input, std::string::size_type&
 
 ////////////////////////////////////////////////////////////////////////////////
 // number := <int> [<frac>] [<exp>]
-bool json::SAX::isNumber (const std::string& input, std::string::size_type& cursor, SAX::Sink& sink)
+bool json::SAX::isNumber (const std::string& input, std::string::size_type& cursor, SAX::ViewSink& sink)
 {
   ignoreWhitespace (input, cursor);
   auto backup = cursor;
@@ -341,37 +746,28 @@ bool json::SAX::isNumber (const std::string& input, std::string::size_type& curs
     std::string exponentPart;
     isExp (input, cursor, exponentPart);
 
-    // Does it fit in a long?
-    std::string combined = integerPart + fractionalPart + exponentPart;
-    char* end;
-    long longValue = strtol (combined.c_str (), &end, 10);
-    if (! *end && errno != ERANGE)
-    {
-      sink.eventValueInt (longValue);
-      return true;
-    }
-
-    // Does it fit in an unsigned long?
-    unsigned long ulongValue = strtoul (combined.c_str (), &end, 10);
-    if (! *end && errno != ERANGE)
-    {
-      sink.eventValueUint (ulongValue);
-      return true;
-    }
-
-    // If the above fail, allow this one to be capped at imax.
-    double doubleValue = strtod (combined.c_str (), &end);
-    if (! *end)
-    {
-      sink.eventValueDouble (doubleValue);
+    if (number (integerPart + fractionalPart + exponentPart, sink))
       return true;
-    }
   }
 
   cursor = backup;
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Sends the number as the narrowest of int, uint and double that holds it.
+bool json::SAX::number (std::string_view combined, SAX::ViewSink& sink)
+{
+  json::number value;
+  if (! json::number::convert (combined, value))
+    return false;
+
+       if (value._kind == json::number::intvalue)  sink.eventValueInt    (value._ivalue);
+  else if (value._kind == json::number::uintvalue) sink.eventValueUint   (value._uvalue);
+  else                                             sink.eventValueDouble (value._dvalue);
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // int := ['-'] <digits>
 bool json::SAX::isInt (const std::string& input, std::string::size_type& cursor, std::string& value)
@@ -485,7 +881,7 @@ bool json::SAX::isE (const std::string& input, std::string::size_type& cursor)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool json::SAX::isBool (const std::string& input, std::string::size_type& cursor, SAX::Sink& sink)
+bool json::SAX::isBool (const std::string& input, std::string::size_type& cursor, SAX::ViewSink& sink)
 {
   ignoreWhitespace (input, cursor);
 
@@ -513,7 +909,7 @@ bool json::SAX::isBool (const std::string& input, std::string::size_type& cursor
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool json::SAX::isNull (const std::string& input, std::string::size_type& cursor, SAX::Sink& sink)
+bool json::SAX::isNull (const std::string& input, std::string::size_type& cursor, SAX::ViewSink& sink)
 {
   ignoreWhitespace (input, cursor);
 
@@ -574,4 +970,344 @@ void json::SAX::error (const std::string& message, std::string::size_type cursor
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+json::SAX::Stream::Stream (SAX::Sink& sink)
+: _adapter (new SinkAdapter (sink))
+, _sink (*_adapter)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::SAX::Stream::Stream (SAX::ViewSink& sink)
+: _sink (sink)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::SAX::Stream::feed (const char* data, std::size_t length)
+{
+  if (_state == state::start && _offset == 0 && length)
+    _sink.eventDocStart ();
+
+  std::size_t i = 0;
+  while (i < length)
+  {
+    // Most of a document is string content, which is copied in runs.
+    if (_state == state::string)
+    {
+      auto run = scan_until (data + i, length - i, '"', '\\');
+      _token.append (data + i, run);
+      i       += run;
+      _offset += run;
+      if (i == length)
+        break;
+    }
+
+    consume (data[i]);
+    ++i;
+    ++_offset;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::SAX::Stream::finish ()
+{
+  switch (_state)
+  {
+  case state::done:
+    _sink.eventDocEnd ();
+    break;
+
+  case state::start:
+    error ("Error: Missing '{' or '[' at position ", _offset);
+    break;
+
+  case state::string:
+  case state::escape:
+  case state::unicode:
+    error ("Error: Missing '\"' at position ", _offset);
+    break;
+
+  default:
+    error (_open.back () == '{' ? "Error: Missing '}' at position "
+                                : "Error: Missing ']' at position ", _offset);
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Advances the state machine by one byte, from any state but a string run.
+// A byte that ends a number, or an invalid \u escape, is then reconsidered in
+// the resulting state.
+void json::SAX::Stream::consume (char c)
+{
+  switch (_state)
+  {
+  case state::start:
+    if (isSpace (c))
+      return;
+
+    if (c != '{' && c != '[')
+      error ("Error: Missing '{' or '[' at position ", _offset);
+
+    beginValue (c);
+    return;
+
+  case state::value:
+    if (isSpace (c))
+      return;
+
+    if (! beginValue (c))
+      error ("Error: Missing value at position ", _offset);
+    return;
+
+  case state::member:
+    if (isSpace (c))
+      return;
+
+    if (c == '"')
+    {
+      _key   = true;
+      _state = state::string;
+    }
+    else if (c == '}')
+    {
+      _open.pop_back ();
+      _sink.eventObjectEnd (_counts.back ());
+      _counts.pop_back ();
+      endValue ();
+    }
+    else
+      error ("Error: Missing '}' at position ", _offset);
+    return;
+
+  case state::element:
+    if (isSpace (c))
+      return;
+
+    if (c == ']')
+    {
+      _open.pop_back ();
+      _sink.eventArrayEnd (_counts.back ());
+      _counts.pop_back ();
+      endValue ();
+    }
+    else if (! beginValue (c))
+      error ("Error: Missing ']' at position ", _offset);
+    return;
+
+  case state::colon:
+    if (isSpace (c))
+      return;
+
+    if (c != ':')
+      error ("Error: Missing ':' at position ", _offset);
+
+    _state = state::value;
+    return;
+
+  case state::separator:
+    if (isSpace (c))
+      return;
+
+    if (c == ',')
+      _state = _open.back () == '{' ? state::member : state::element;
+    else if (c == '}' && _open.back () == '{')
+    {
+      _open.pop_back ();
+      _sink.eventObjectEnd (_counts.back ());
+      _counts.pop_back ();
+      endValue ();
+    }
+    else if (c == ']' && _open.back () == '[')
+    {
+      _open.pop_back ();
+      _sink.eventArrayEnd (_counts.back ());
+      _counts.pop_back ();
+      endValue ();
+    }
+    else
+      error (_open.back () == '{' ? "Error: Missing '}' at position "
+                                  : "Error: Missing ']' at position ", _offset);
+    return;
+
+  case state::string:
+    if (c == '"')
+      endString ();
+    else if (c == '\\')
+      _state = state::escape;
+    else
+      _token += c;
+    return;
+
+  case state::escape:
+    _state = state::string;
+    switch (c)
+    {
+    case 'u':  _state = state::unicode; _hex.clear (); break;
+    case 'b':  _token += (char) 0x08; break;
+    case 'f':  _token += (char) 0x0C; break;
+    case 'n':  _token += (char) 0x0A; break;
+    case 'r':  _token += (char) 0x0D; break;
+    case 't':  _token += (char) 0x09; break;
+    case 'v':  _token += (char) 0x0B; break;
+
+    // As in isStringValue, anything else escapes itself.
+    default:   _token += c;           break;
+    }
+    return;
+
+  case state::unicode:
+    if (isHexDigit (c))
+    {
+      _hex += c;
+      if (_hex.length () == 4)
+      {
+        _token += utf8_character (hexToInt (_hex[0], _hex[1], _hex[2], _hex[3]));
+        _state = state::string;
+      }
+      return;
+    }
+
+    // Not a \uXXXX escape after all, so the 'u' was escaped on its own.
+    _token += 'u';
+    _token += _hex;
+    _state = state::string;
+    consume (c);
+    return;
+
+  case state::number:
+    {
+      // Tracks the grammar by the previous character, which is enough to
+      // tell whether c continues the number.
+      char last = _token.back ();
+      bool digit = isDecDigit (c);
+      if (digit ||
+          (c == '.'               && isDecDigit (last) && _token.find_first_of (".eE") == std::string::npos) ||
+          ((c == 'e' || c == 'E') && isDecDigit (last) && _token.find_first_of ("eE")  == std::string::npos) ||
+          ((c == '+' || c == '-') && (last == 'e' || last == 'E')))
+      {
+        _token += c;
+        return;
+      }
+
+      endNumber ();
+      consume (c);
+    }
+    return;
+
+  case state::literal:
+    if (c != *_expect)
+      error ("Error: Missing value at position ", _offset);
+
+    if (*++_expect == '\0')
+    {
+      switch (c)
+      {
+      case 'e': _sink.eventValueBool (_token == "t"); break;
+      case 'l': _sink.eventValueNull ();               break;
+      }
+
+      endValue ();
+    }
+    return;
+
+  case state::done:
+    if (! isSpace (c))
+      error ("Error: extra characters found at position ", _offset);
+    return;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Starts the value that c introduces, or returns false if c cannot.
+bool json::SAX::Stream::beginValue (char c)
+{
+  switch (c)
+  {
+  case '{':
+    _open.push_back ('{');
+    _counts.push_back (0);
+    _sink.eventObjectStart ();
+    _state = state::member;
+    return true;
+
+  case '[':
+    _open.push_back ('[');
+    _counts.push_back (0);
+    _sink.eventArrayStart ();
+    _state = state::element;
+    return true;
 
+  case '"':
+    _key   = false;
+    _state = state::string;
+    return true;
+
+  case 't': _token = "t"; _expect = "rue";  _state = state::literal; return true;
+  case 'f': _token = "f"; _expect = "alse"; _state = state::literal; return true;
+  case 'n': _token = "n"; _expect = "ull";  _state = state::literal; return true;
+
+  default:
+    if (c == '-' || isDecDigit (c))
+    {
+      _token = c;
+      _state = state::number;
+      return true;
+    }
+
+    return false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Moves on from a completed value, which for the outermost value ends the
+// document.
+void json::SAX::Stream::endValue ()
+{
+  _token.clear ();
+  if (_open.empty ())
+  {
+    _state = state::done;
+    return;
+  }
+
+  ++_counts.back ();
+  _state = state::separator;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::SAX::Stream::endString ()
+{
+  if (_key)
+  {
+    _sink.eventName (_token);
+    _token.clear ();
+    _state = state::colon;
+  }
+  else
+  {
+    _sink.eventValueString (_token);
+    endValue ();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A number must end with a digit; anything else is a partial fraction or
+// exponent.
+void json::SAX::Stream::endNumber ()
+{
+  if (! isDecDigit (_token.back ()) || ! number (_token, _sink))
+    error ("Error: Missing value at position ", _offset);
+
+  endValue ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The same characters that ignoreWhitespace skips.
+bool json::SAX::Stream::isSpace (char c)
+{
+  return c == ' '  || c == '\t' || c == '\n' ||
+         c == '\v' || c == '\f' || c == '\r';
+}
+
+////////////////////////////////////////////////////////////////////////////////
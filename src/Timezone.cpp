@@ -0,0 +1,554 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Timezone.h>
+#include <Datetime.h>
+#include <format.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Changes given by a footer rule are listed up to the end of this year, and
+// calculated as needed beyond it.
+static const int listedYear = 2100;
+
+static const std::size_t noHint = static_cast <std::size_t> (-1);
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string defaultDirectory ()
+{
+  auto tzdir = getenv ("TZDIR");
+  return tzdir && *tzdir ? tzdir : "/usr/share/zoneinfo";
+}
+
+std::string Timezone::directory = defaultDirectory ();
+
+////////////////////////////////////////////////////////////////////////////////
+// A big-endian, two's complement integer of the given size.
+static int64_t readInteger (const unsigned char* data, int bytes)
+{
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; ++i)
+    value = (value << 8) | data[i];
+
+  if (bytes < 8 && (value >> (bytes * 8 - 1)))
+    value |= ~uint64_t (0) << (bytes * 8);
+
+  return (int64_t) value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static int yearOf (int64_t seconds)
+{
+  auto days = seconds / 86400;
+  if (seconds % 86400 < 0)
+    --days;
+
+  int year, month, day;
+  Datetime::civilFromDays (days, year, month, day);
+  return year;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Zones are read once, and never unloaded, so the references handed out stay
+// valid.
+const Timezone& Timezone::get (const std::string& name)
+{
+  static std::mutex mutex;
+  static std::map <std::string, std::unique_ptr <Timezone>> zones;
+
+  std::lock_guard <std::mutex> lock (mutex);
+  auto found = zones.find (name);
+  if (found != zones.end ())
+    return *found->second;
+
+  if (name.empty () || name[0] == '/' || name.find ("..") != std::string::npos)
+    throw format ("Error: unknown time zone '{1}'.", name);
+
+  std::ifstream in (directory + '/' + name, std::ios::binary);
+  if (! in.good ())
+    throw format ("Error: unknown time zone '{1}'.", name);
+
+  std::string contents ((std::istreambuf_iterator <char> (in)), std::istreambuf_iterator <char> ());
+  auto& zone = zones[name];
+  zone.reset (new Timezone (parse (name, contents)));
+  return *zone;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads TZif data, as described by RFC 8536.  Leap second records are
+// skipped, so zones under "right/" are read as though they had none.
+Timezone Timezone::parse (const std::string& name, const std::string& contents)
+{
+  auto invalid = format ("Error: '{1}' is not a valid TZif file.", name);
+  auto data = reinterpret_cast <const unsigned char*> (contents.data ());
+
+  enum {isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt};
+  int64_t counts[6];
+  std::size_t pos = 0;
+
+  // Reads the header at pos, and gives the length of the data block after it.
+  auto header = [&] (int timeSize) -> std::size_t
+  {
+    if (pos + 44 > contents.length () ||
+        contents.compare (pos, 4, "TZif") != 0)
+      throw invalid;
+
+    for (int i = 0; i < 6; ++i)
+      if ((counts[i] = readInteger (data + pos + 20 + i * 4, 4)) < 0)
+        throw invalid;
+
+    pos += 44;
+    return counts[timecnt] * (timeSize + 1)
+         + counts[typecnt] * 6
+         + counts[charcnt]
+         + counts[leapcnt] * (timeSize + 4)
+         + counts[isstdcnt]
+         + counts[isutcnt];
+  };
+
+  // Version 2 and later repeat the data with 64-bit times, which are used in
+  // place of the first block.
+  int timeSize = 4;
+  auto length = header (timeSize);
+  if (contents[4] >= '2')
+  {
+    pos += length;
+    timeSize = 8;
+    length = header (timeSize);
+  }
+
+  if (pos + length > contents.length () ||
+      counts[typecnt] == 0 ||
+      counts[typecnt] > 256)
+    throw invalid;
+
+  auto times   = data + pos;
+  auto indexes = times + counts[timecnt] * timeSize;
+  auto types   = indexes + counts[timecnt];
+  std::string abbreviations (reinterpret_cast <const char*> (types + counts[typecnt] * 6), counts[charcnt]);
+
+  Timezone zone;
+  zone._name = name;
+
+  for (int64_t i = 0; i < counts[typecnt]; ++i)
+  {
+    auto entry = types + i * 6;
+    std::size_t start = entry[5];
+    if (start >= abbreviations.length ())
+      throw invalid;
+
+    auto end = abbreviations.find ('\0', start);
+    zone._types.push_back ({(int32_t) readInteger (entry, 4),
+                            entry[4] != 0,
+                            abbreviations.substr (start, end == std::string::npos ? end : end - start)});
+  }
+
+  for (int64_t i = 0; i < counts[timecnt]; ++i)
+  {
+    auto when = readInteger (times + i * timeSize, timeSize);
+    if (indexes[i] >= counts[typecnt] ||
+        (i && when <= zone._times.back ()))
+      throw invalid;
+
+    zone._times.push_back (when);
+    zone._indexes.push_back (indexes[i]);
+  }
+
+  // The footer, a POSIX TZ string between newlines, gives the rule for times
+  // after the last transition.
+  pos += length;
+  if (timeSize == 8 &&
+      pos < contents.length () &&
+      contents[pos] == '\n')
+  {
+    auto end = contents.find ('\n', pos + 1);
+    if (end == std::string::npos)
+      throw invalid;
+
+    zone.parse_footer (contents.substr (pos + 1, end - pos - 1));
+  }
+
+  zone.extend (listedYear);
+  return zone;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& Timezone::name () const
+{
+  return _name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const Timezone::type& Timezone::at (time_t when) const
+{
+  std::size_t hint = noHint;
+  return at (when, hint);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Timezone::offset (time_t when) const
+{
+  return at (when).offset;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The local time, in seconds since the epoch as though it were UTC.
+int64_t Timezone::toLocal (time_t when) const
+{
+  return when + at (when).offset;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+time_t Timezone::toUTC (int64_t local) const
+{
+  std::size_t hint = noHint;
+  return toUTC (local, hint);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Each search starts from the transition the last one found, so times that
+// are close together cost little more than an array lookup.
+void Timezone::toLocal (const std::vector <time_t>& times, std::vector <int64_t>& locals) const
+{
+  locals.resize (times.size ());
+
+  std::size_t hint = noHint;
+  for (std::size_t i = 0; i < times.size (); ++i)
+    locals[i] = times[i] + at (times[i], hint).offset;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Timezone::toUTC (const std::vector <int64_t>& locals, std::vector <time_t>& times) const
+{
+  times.resize (locals.size ());
+
+  std::size_t hint = noHint;
+  for (std::size_t i = 0; i < locals.size (); ++i)
+    times[i] = toUTC (locals[i], hint);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads a POSIX TZ string, such as "CET-1CEST,M3.5.0,M10.5.0/3", with the
+// extensions of RFC 8536: hours up to 167, and negative times of day.
+void Timezone::parse_footer (const std::string& footer)
+{
+  if (footer.empty ())
+    return;
+
+  auto invalid = format ("Error: '{1}' has an invalid TZ rule '{2}'.", _name, footer);
+  std::size_t pos = 0;
+
+  auto more = [&] () { return pos < footer.length (); };
+  auto skip = [&] (char c)
+  {
+    if (! more () || footer[pos] != c)
+      throw invalid;
+
+    ++pos;
+  };
+
+  auto number = [&] (int minimum, int maximum)
+  {
+    auto start = pos;
+    int value = 0;
+    while (more () && isdigit ((unsigned char) footer[pos]) && pos - start < 3)
+      value = value * 10 + (footer[pos++] - '0');
+
+    if (pos == start || value < minimum || value > maximum)
+      throw invalid;
+
+    return value;
+  };
+
+  // Either alphabetic, or any text between '<' and '>'.
+  auto name = [&] ()
+  {
+    auto start = pos;
+    if (more () && footer[pos] == '<')
+    {
+      pos = footer.find ('>', pos);
+      if (pos == std::string::npos)
+        throw invalid;
+
+      return footer.substr (start + 1, pos++ - start - 1);
+    }
+
+    while (more () && isalpha ((unsigned char) footer[pos]))
+      ++pos;
+
+    if (pos - start < 3)
+      throw invalid;
+
+    return footer.substr (start, pos - start);
+  };
+
+  // [+|-]hh[:mm[:ss]]
+  auto seconds = [&] ()
+  {
+    int sign = 1;
+    if (more () && (footer[pos] == '+' || footer[pos] == '-'))
+      sign = footer[pos++] == '-' ? -1 : 1;
+
+    int32_t value = number (0, 167) * 3600;
+    if (more () && footer[pos] == ':')
+    {
+      ++pos;
+      value += number (0, 59) * 60;
+      if (more () && footer[pos] == ':')
+      {
+        ++pos;
+        value += number (0, 59);
+      }
+    }
+
+    return sign * value;
+  };
+
+  // Jn, n or Mm.w.d, and then an optional /time.
+  auto date = [&] (rule& change)
+  {
+    if (more () && footer[pos] == 'J')
+    {
+      ++pos;
+      change.kind = rule::form::julian;
+      change.day  = number (1, 365);
+    }
+    else if (more () && footer[pos] == 'M')
+    {
+      ++pos;
+      change.kind  = rule::form::month;
+      change.month = number (1, 12);
+      skip ('.');
+      change.week  = number (1, 5);
+      skip ('.');
+      change.day   = number (0, 6);
+    }
+    else
+    {
+      change.kind = rule::form::zero;
+      change.day  = number (0, 365);
+    }
+
+    if (more () && footer[pos] == '/')
+    {
+      ++pos;
+      change.seconds = seconds ();
+    }
+  };
+
+  // POSIX offsets are west of UTC, and so have the opposite sign.
+  auto standardName = name ();
+  auto standardOffset = -seconds ();
+  _standard = add_type (standardOffset, false, standardName);
+  _hasRule  = true;
+  if (! more ())
+    return;
+
+  auto summerName = name ();
+  auto summerOffset = standardOffset + 3600;
+  if (more () && footer[pos] != ',')
+    summerOffset = -seconds ();
+
+  _summer = add_type (summerOffset, true, summerName);
+  _hasDst = true;
+
+  // Without dates, POSIX leaves the rule to the implementation.  This is the
+  // one most of them use.
+  if (! more ())
+  {
+    _start = {rule::form::month, 0, 2, 3,  7200};
+    _end   = {rule::form::month, 0, 1, 11, 7200};
+    return;
+  }
+
+  skip (',');
+  date (_start);
+  skip (',');
+  date (_end);
+  if (more ())
+    throw invalid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t Timezone::add_type (int32_t offset, bool dst, const std::string& abbreviation)
+{
+  for (std::size_t i = 0; i < _types.size (); ++i)
+    if (_types[i].offset       == offset &&
+        _types[i].dst          == dst    &&
+        _types[i].abbreviation == abbreviation)
+      return i;
+
+  _types.push_back ({offset, dst, abbreviation});
+  return _types.size () - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Lists the changes given by the footer rule, after the last transition and
+// up to the end of the year, so that lookups in that range are a search.
+void Timezone::extend (int last)
+{
+  if (! _hasDst)
+    return;
+
+  auto& standard = _types[_standard];
+  auto& summer   = _types[_summer];
+
+  for (int year = _times.empty () ? 1970 : yearOf (_times.back ()); year <= last; ++year)
+  {
+    std::pair <int64_t, std::size_t> changes[2] {
+      {change (_start, year) - standard.offset, _summer},
+      {change (_end,   year) - summer.offset,   _standard}};
+
+    if (changes[1].first < changes[0].first)
+      std::swap (changes[0], changes[1]);
+
+    for (auto& next : changes)
+      if (_times.empty () || next.first > _times.back ())
+      {
+        _times.push_back (next.first);
+        _indexes.push_back (next.second);
+      }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The local time, in seconds since the epoch as though it were UTC, at which
+// the rule takes effect in the given year.
+int64_t Timezone::change (const rule& date, int year) const
+{
+  auto first = Datetime::daysFromCivil (year, 1, 1);
+  int64_t days;
+
+  if (date.kind == rule::form::julian)
+  {
+    // Day 1 to 365, where February 29th is never counted.
+    days = first + date.day - 1;
+    if (date.day >= 60 && Datetime::leapYear (year))
+      ++days;
+  }
+  else if (date.kind == rule::form::zero)
+  {
+    days = first + date.day;
+  }
+  else
+  {
+    // The given weekday in the given week of the month, where week 5 is the
+    // last.
+    first = Datetime::daysFromCivil (year, date.month, 1);
+    int weekday = (first % 7 + 11) % 7;
+    days = first + (date.day - weekday + 7) % 7 + (date.week - 1) * 7;
+
+    auto last = (date.month == 12 ? Datetime::daysFromCivil (year + 1, 1, 1)
+                                  : Datetime::daysFromCivil (year, date.month + 1, 1)) - 1;
+    while (days > last)
+      days -= 7;
+  }
+
+  return days * 86400 + date.seconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// As before the first transition the first type applies, and after the last,
+// the footer rule.  Hint is the transition found by the last call.
+const Timezone::type& Timezone::at (time_t when, std::size_t& hint) const
+{
+  if (_times.empty ())
+    return _hasRule ? after (when) : _types[0];
+
+  if (when < _times.front ())
+    return _types[0];
+
+  auto last = _times.size () - 1;
+  if (when >= _times[last])
+    return _hasRule ? after (when) : _types[_indexes[last]];
+
+  if (hint >= last ||
+      when <  _times[hint] ||
+      when >= _times[hint + 1])
+    hint = std::upper_bound (_times.begin (), _times.end (), when) - _times.begin () - 1;
+
+  return _types[_indexes[hint]];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Calculates the footer rule for times beyond those listed.
+const Timezone::type& Timezone::after (time_t when) const
+{
+  auto& standard = _types[_standard];
+  if (! _hasDst)
+    return standard;
+
+  auto& summer = _types[_summer];
+  auto year  = yearOf (when + standard.offset);
+  auto start = change (_start, year) - standard.offset;
+  auto end   = change (_end,   year) - summer.offset;
+
+  // In the southern hemisphere, summer time spans the new year.
+  bool dst = start < end ? (start <= when && when < end)
+                         : ! (end <= when && when < start);
+  return dst ? summer : standard;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Solves local = utc + offset (utc).  A local time repeated when the clocks go
+// back is taken at its first occurrence.  One skipped when they go forward is
+// taken at the offset before the change, as mktime does, so 02:30 becomes
+// 03:30.  This assumes no two changes are within a day of each other.
+time_t Timezone::toUTC (int64_t local, std::size_t& hint) const
+{
+  int64_t before = at (local, hint).offset;
+  time_t first = local - before;
+  bool firstFits = at (first, hint).offset == before;
+
+  int64_t other;
+  if (firstFits)
+  {
+    // There may be an earlier solution, if the clocks went back in the day
+    // before.
+    other = at (first - 86400, hint).offset;
+    if (other == before)
+      return first;
+  }
+  else
+    other = at (first, hint).offset;
+
+  time_t second = local - other;
+  if (at (second, hint).offset == other)
+    return second;
+
+  if (firstFits)
+    return first;
+
+  return std::max (first, second);
+}
+
+////////////////////////////////////////////////////////////////////////////////
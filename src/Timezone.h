@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_TIMEZONE
+#define INCLUDED_TIMEZONE
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// A time zone, read from a TZif file of the tz database.  Zones are loaded
+// once, on first use, and then kept for the life of the process, so that a
+// Timezone may be shared between threads without locking.
+class Timezone
+{
+public:
+  // The rules in effect between two transitions.
+  struct type
+  {
+    int32_t     offset       {0};      // Seconds east of UTC.
+    bool        dst          {false};
+    std::string abbreviation {};
+  };
+
+  static std::string directory;
+
+  static const Timezone& get (const std::string&);
+  static Timezone parse (const std::string&, const std::string&);
+
+  const std::string& name () const;
+  const type& at (time_t) const;
+  int offset (time_t) const;
+  int64_t toLocal (time_t) const;
+  time_t toUTC (int64_t) const;
+
+  void toLocal (const std::vector <time_t>&, std::vector <int64_t>&) const;
+  void toUTC (const std::vector <int64_t>&, std::vector <time_t>&) const;
+
+private:
+  // A POSIX TZ rule, from the footer of the file, which gives the
+  // transitions after the last one listed.
+  struct rule
+  {
+    enum class form {julian, zero, month};
+
+    form    kind    {form::month};
+    int     day     {0};      // Julian day, or day of the week for form::month.
+    int     week    {0};
+    int     month   {0};
+    int32_t seconds {7200};   // Local time of day of the change.
+  };
+
+  Timezone () = default;
+  void parse_footer (const std::string&);
+  std::size_t add_type (int32_t, bool, const std::string&);
+  void extend (int);
+  int64_t change (const rule&, int) const;
+  const type& at (time_t, std::size_t&) const;
+  const type& after (time_t) const;
+  time_t toUTC (int64_t, std::size_t&) const;
+
+private:
+  std::string           _name     {};
+  std::vector <type>    _types    {};
+  std::vector <int64_t> _times    {};   // Transitions, in order.
+  std::vector <uint16_t> _indexes {};   // The type from each transition on.
+
+  // The footer rule.  When it has no summer time, only _standard applies.
+  bool                  _hasRule  {false};
+  bool                  _hasDst   {false};
+  std::size_t           _standard {0};
+  std::size_t           _summer   {0};
+  rule                  _start    {};
+  rule                  _end      {};
+};
+
+#endif
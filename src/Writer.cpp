@@ -0,0 +1,238 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <JSON.h>
+#include <charconv>
+#include <format.h>
+#include <ostream>
+
+// Output for a stream is collected in a buffer, and written out whenever it
+// grows beyond this.
+static const std::size_t flushThreshold = 16384;
+
+////////////////////////////////////////////////////////////////////////////////
+json::Writer::Writer (std::string& output, int indent)
+: _output (output)
+, _indent (indent)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::Writer::Writer (std::ostream& out, int indent)
+: _output (_buffer)
+, _stream (&out)
+, _indent (indent)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+json::Writer::~Writer ()
+{
+  flush ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::beginObject ()
+{
+  separate ();
+  _output += '{';
+  ++_depth;
+  _first = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::endObject ()
+{
+  close ('}');
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::beginArray ()
+{
+  separate ();
+  _output += '[';
+  ++_depth;
+  _first = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::endArray ()
+{
+  close (']');
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::key (std::string_view name)
+{
+  separate ();
+  _output += '"';
+  encode (_output, name);
+  _output += _indent ? "\": " : "\":";
+  _named = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::encodedKey (std::string_view name)
+{
+  separate ();
+  _output += '"';
+  _output.append (name.data (), name.length ());
+  _output += _indent ? "\": " : "\":";
+  _named = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::value (std::string_view text)
+{
+  separate ();
+  _output += '"';
+  encode (_output, text);
+  _output += '"';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::value (const char* text)
+{
+  value (std::string_view (text));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::value (double number)
+{
+  separate ();
+  _output += format (number);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::value (int64_t number)
+{
+  separate ();
+  char buffer[24];
+  auto end = std::to_chars (buffer, buffer + sizeof (buffer), number).ptr;
+  _output.append (buffer, end - buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::value (uint64_t number)
+{
+  separate ();
+  char buffer[24];
+  auto end = std::to_chars (buffer, buffer + sizeof (buffer), number).ptr;
+  _output.append (buffer, end - buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::value (int number)
+{
+  value ((int64_t) number);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::value (bool flag)
+{
+  separate ();
+  _output += flag ? "true" : "false";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::null ()
+{
+  separate ();
+  _output += "null";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::encodedValue (std::string_view text)
+{
+  separate ();
+  _output += '"';
+  _output.append (text.data (), text.length ());
+  _output += '"';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Emits text that is already JSON, such as a preformatted number.
+void json::Writer::raw (std::string_view text)
+{
+  separate ();
+  _output.append (text.data (), text.length ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes out any buffered stream output.  Output to a string needs no flush.
+void json::Writer::flush ()
+{
+  if (_stream && ! _buffer.empty ())
+  {
+    _stream->write (_buffer.data (), _buffer.length ());
+    _buffer.clear ();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Emits whatever precedes the next key or value: nothing after a key, and
+// otherwise the comma and, when indenting, the line break.
+void json::Writer::separate ()
+{
+  if (_stream && _buffer.length () >= flushThreshold)
+    flush ();
+
+  if (_named)
+  {
+    _named = false;
+    return;
+  }
+
+  if (_depth > 0)
+  {
+    if (! _first)
+      _output += ',';
+
+    if (_indent)
+    {
+      _output += '\n';
+      _output.append (_depth * _indent, ' ');
+    }
+  }
+
+  _first = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void json::Writer::close (char bracket)
+{
+  --_depth;
+  if (_indent && ! _first)
+  {
+    _output += '\n';
+    _output.append (_depth * _indent, ' ');
+  }
+
+  _output += bracket;
+  _first = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -26,11 +26,13 @@
 
 #include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <clocale>
 #include <cmake.h>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <format.h>
-#include <iomanip>
 #include <sstream>
 #ifndef _WIN32
 #include <strings.h>
@@ -51,58 +53,125 @@ std::string format (const char* value)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string formatHex (int value)
+// Renders value with printf-style precision, as %.*f when fixed and as %.*g
+// otherwise.  Without std::to_chars for doubles, snprintf writes the decimal
+// point of LC_NUMERIC, which is put back to '.'.
+static std::string_view render_double (char (&buffer)[512], double value, bool fixed, int precision)
 {
-  std::stringstream s;
-  s.setf (std::ios::hex, std::ios::basefield);
-  s << value;
-  return s.str ();
+#ifdef HAVE_TO_CHARS_DOUBLE
+  auto result = std::to_chars (buffer, buffer + sizeof (buffer), value,
+                               fixed ? std::chars_format::fixed : std::chars_format::general,
+                               precision);
+  if (result.ec == std::errc ())
+    return std::string_view (buffer, result.ptr - buffer);
+#endif
+
+  auto length = std::min ((std::size_t) std::max (snprintf (buffer, sizeof (buffer), fixed ? "%.*f" : "%.*g", precision, value), 0),
+                          sizeof (buffer) - 1);
+
+  std::string_view point = localeconv ()->decimal_point;
+  if (! point.empty () && point != ".")
+  {
+    auto found = std::string_view (buffer, length).find (point);
+    if (found != std::string_view::npos)
+    {
+      buffer[found] = '.';
+      std::memmove (buffer + found + 1, buffer + found + point.length (), length - found - point.length ());
+      length -= point.length () - 1;
+    }
+  }
+
+  return std::string_view (buffer, length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string format (float value, int width, int precision)
+static void append_double (std::string& output, double value, bool fixed, int precision)
+{
+  char buffer[512];
+  output += render_double (buffer, value, fixed, precision);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Appends text right-aligned in width, as std::setw would, with fill.
+static void append_padded (std::string& output, std::string_view text, int width, char fill)
+{
+  if (width > (int) text.length ())
+    output.append (width - text.length (), fill);
+
+  output += text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Right-aligned in width, as a stream would show it, but for value close to
+// zero, width - 2 (2 accounts for the first zero and the dot) is the number
+// of digits after zero that are significant.
+template <typename T>
+static void append_width_precision (std::string& output, T value, int width, int precision, T (*rounding) (T))
 {
-  std::stringstream s;
-  s.width (width);
-  s.precision (precision);
   if (0 < value && value < 1)
   {
-    // For value close to zero, width - 2 (2 accounts for the first zero and
-    // the dot) is the number of digits after zero that are significant
     double factor = 1;
     for (int i = 2; i < width; i++)
       factor *= 10;
-    value = roundf (value * factor) / factor;
+    value = rounding (value * factor) / factor;
   }
-  s << value;
-  return s.str ();
+
+  char buffer[512];
+  append_padded (output, render_double (buffer, value, false, precision), width, ' ');
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Two's complement for negative values, as a stream shows them.
+void appendHex (std::string& output, int value)
+{
+  char buffer[16];
+  auto result = std::to_chars (buffer, buffer + sizeof (buffer), static_cast <unsigned int> (value), 16);
+  output.append (buffer, result.ptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string formatHex (int value)
+{
+  std::string output;
+  appendHex (output, value);
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void appendFormat (std::string& output, float value, int width, int precision)
+{
+  append_width_precision <float> (output, value, width, precision, roundf);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string format (float value, int width, int precision)
+{
+  std::string output;
+  appendFormat (output, value, width, precision);
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void appendFormat (std::string& output, double value, int width, int precision)
+{
+  append_width_precision <double> (output, value, width, precision, round);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string format (double value, int width, int precision)
 {
-  std::stringstream s;
-  s.width (width);
-  s.precision (precision);
-  if (0 < value && value < 1)
-  {
-    // For value close to zero, width - 2 (2 accounts for the first zero and
-    // the dot) is the number of digits after zero that are significant
-    double factor = 1;
-    for (int i = 2; i < width; i++)
-      factor *= 10;
-    value = round (value * factor) / factor;
-  }
-  s << value;
-  return s.str ();
+  std::string output;
+  appendFormat (output, value, width, precision);
+  return output;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// As std::fixed.
 std::string format (double value)
 {
-  std::stringstream s;
-  s << std::fixed << value;
-  return s.str ();
+  std::string output;
+  append_double (output, value, true, 6);
+  return output;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -119,13 +188,120 @@ void replace_positional (
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void format_append (std::string& output, const std::string& value)
+{
+  output += value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void format_append (std::string& output, std::string_view value)
+{
+  output += value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void format_append (std::string& output, const char* value)
+{
+  output += value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void format_append (std::string& output, char value)
+{
+  output += value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// As a stream shows it, without std::boolalpha.
+void format_append (std::string& output, bool value)
+{
+  output += value ? '1' : '0';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+static void append_integer (std::string& output, T value)
+{
+  char buffer[24];
+  auto result = std::to_chars (buffer, buffer + sizeof (buffer), value);
+  output.append (buffer, result.ptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void format_append (std::string& output, int value)                { append_integer (output, value); }
+void format_append (std::string& output, unsigned int value)       { append_integer (output, value); }
+void format_append (std::string& output, long value)               { append_integer (output, value); }
+void format_append (std::string& output, unsigned long value)      { append_integer (output, value); }
+void format_append (std::string& output, long long value)          { append_integer (output, value); }
+void format_append (std::string& output, unsigned long long value) { append_integer (output, value); }
+
+////////////////////////////////////////////////////////////////////////////////
+// A stream's default, which is %g.
+void format_append (std::string& output, float value)
+{
+  append_double (output, value, false, 6);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// As format (double), std::fixed, which is %f.
+void format_append (std::string& output, double value)
+{
+  append_double (output, value, true, 6);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copies the format to the output, appending argument N in place of each {N}.
+// Anything else in braces, such as {0}, {01} or a number beyond the last
+// argument, is copied unchanged, as is any text an argument brings in.
+void format_positional (
+  std::string& output,
+  std::string_view fmt,
+  const format_argument* arguments,
+  std::size_t count)
+{
+  output.reserve (fmt.length () + 16 * count);
+
+  std::size_t start = 0;
+  for (std::size_t open; (open = fmt.find ('{', start)) != std::string_view::npos; )
+  {
+    std::size_t number = 0;
+    auto end = open + 1;
+    if (end < fmt.length () && fmt[end] != '0')
+      while (end < fmt.length () && isdigit (fmt[end]) && number <= count)
+        number = number * 10 + (fmt[end++] - '0');
+
+    if (end < fmt.length () && fmt[end] == '}' && number >= 1 && number <= count)
+    {
+      output.append (fmt, start, open - start);
+      arguments[number - 1].append (output, arguments[number - 1].value);
+      start = end + 1;
+    }
+    else
+    {
+      output.append (fmt, start, open + 1 - start);
+      start = open + 1;
+    }
+  }
+
+  output.append (fmt, start);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void appendLeftJustify (std::string& output, int input, int width)
+{
+  auto length = output.length ();
+  append_integer (output, input);
+  if (width > (int) (output.length () - length))
+    output.append (width - (output.length () - length), ' ');
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string leftJustify (const int input, const int width)
 {
-  std::stringstream s;
-  s << input;
-  std::string output = s.str ();
-  return output + std::string (std::max<int> (width - output.length (), 0), ' ');
+  std::string output;
+  appendLeftJustify (output, input, width);
+  return output;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -134,20 +310,37 @@ std::string leftJustify (const std::string& input, const int width)
   return input + std::string (std::max<int> (width - utf8_text_width (input), 0), ' ');
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// As std::setfill ('0'), which pads before any sign: -42 in 5 is 00-42.
+void appendRightJustifyZero (std::string& output, int input, int width)
+{
+  char buffer[16];
+  auto result = std::to_chars (buffer, buffer + sizeof (buffer), input);
+  append_padded (output, std::string_view (buffer, result.ptr - buffer), width, '0');
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string rightJustifyZero (const int input, const int width)
 {
-  std::stringstream s;
-  s << std::setw (width) << std::setfill ('0') << input;
-  return s.str ();
+  std::string output;
+  appendRightJustifyZero (output, input, width);
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void appendRightJustify (std::string& output, int input, int width)
+{
+  char buffer[16];
+  auto result = std::to_chars (buffer, buffer + sizeof (buffer), input);
+  append_padded (output, std::string_view (buffer, result.ptr - buffer), width, ' ');
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string rightJustify (const int input, const int width)
 {
-  std::stringstream s;
-  s << std::setw (width) << std::setfill (' ') << input;
-  return s.str ();
+  std::string output;
+  appendRightJustify (output, input, width);
+  return output;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -157,13 +350,15 @@ std::string rightJustify (const std::string& input, const int width)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string commify (const std::string& data)
+// Inserts a comma between each group of three digits before the decimal point,
+// or, with no decimal point, before the end of the last run of digits.  The
+// result is written backwards from the end of the output, which is first
+// grown by the most it can need, and then closed up.
+void appendCommify (std::string& output, std::string_view data)
 {
   // First scan for decimal point and end of digits.
   int decimalPoint = -1;
   int end          = -1;
-
-  int i;
   for (int i = 0; i < (int) data.length (); ++i)
   {
     if (isdigit (data[i]))
@@ -173,76 +368,60 @@ std::string commify (const std::string& data)
       decimalPoint = i;
   }
 
-  std::string result;
-  if (decimalPoint != -1)
-  {
-    // In reverse order, transfer all digits up to, and including the decimal
-    // point.
-    for (i = (int) data.length () - 1; i >= decimalPoint; --i)
-      result += data[i];
+  auto base = output.length ();
+  output.resize (base + data.length () + data.length () / 3 + 1);
+  auto out = output.length ();
 
-    int consecutiveDigits = 0;
-    for (; i >= 0; --i)
-    {
-      if (isdigit (data[i]))
-      {
-        result += data[i];
-
-        if (++consecutiveDigits == 3 && i && isdigit (data[i - 1]))
-        {
-          result += ',';
-          consecutiveDigits = 0;
-        }
-      }
-      else
-        result += data[i];
-    }
-  }
-  else
-  {
-    // In reverse order, transfer all digits up to, but not including the last
-    // digit.
-    for (i = (int) data.length () - 1; i > end; --i)
-      result += data[i];
+  // Transfer everything after the grouped digits unchanged, including any
+  // decimal point.
+  int i = (int) data.length () - 1;
+  for (int last = decimalPoint != -1 ? decimalPoint : end + 1; i >= last; --i)
+    output[--out] = data[i];
 
-    int consecutiveDigits = 0;
-    for (; i >= 0; --i)
+  int consecutiveDigits = 0;
+  for (; i >= 0; --i)
+  {
+    output[--out] = data[i];
+    if (isdigit (data[i]) &&
+        ++consecutiveDigits == 3 && i && isdigit (data[i - 1]))
     {
-      if (isdigit (data[i]))
-      {
-        result += data[i];
-
-        if (++consecutiveDigits == 3 && i && isdigit (data[i - 1]))
-        {
-          result += ',';
-          consecutiveDigits = 0;
-        }
-      }
-      else
-        result += data[i];
+      output[--out] = ',';
+      consecutiveDigits = 0;
     }
   }
 
-  // reverse result into data.
-  std::string done;
-  for (int i = (int) result.length () - 1; i >= 0; --i)
-    done += result[i];
+  output.erase (base, out - base);
+}
 
-  return done;
+////////////////////////////////////////////////////////////////////////////////
+std::string commify (const std::string& data)
+{
+  std::string output;
+  appendCommify (output, data);
+  return output;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Convert a quantity in bytes to a more readable format.
-std::string formatBytes (size_t bytes)
+void appendBytes (std::string& output, size_t bytes)
 {
-  char formatted[24];
-
-       if (bytes >=  995000000) snprintf (formatted, sizeof(formatted), "%.1f GiB", bytes / 1000000000.0);
-  else if (bytes >=     995000) snprintf (formatted, sizeof(formatted), "%.1f MiB", bytes /    1000000.0);
-  else if (bytes >=        995) snprintf (formatted, sizeof(formatted), "%.1f KiB", bytes /       1000.0);
-  else                          snprintf (formatted, sizeof(formatted), "%d B",     (int)bytes);
+  char buffer[512];
+       if (bytes >=  995000000) { appendCommify (output, render_double (buffer, bytes / 1000000000.0, true, 1)); output += " GiB"; }
+  else if (bytes >=     995000) { appendCommify (output, render_double (buffer, bytes /    1000000.0, true, 1)); output += " MiB"; }
+  else if (bytes >=        995) { appendCommify (output, render_double (buffer, bytes /       1000.0, true, 1)); output += " KiB"; }
+  else
+  {
+    append_integer (output, (int) bytes);
+    output += " B";
+  }
+}
 
-  return commify (formatted);
+////////////////////////////////////////////////////////////////////////////////
+std::string formatBytes (size_t bytes)
+{
+  std::string output;
+  appendBytes (output, bytes);
+  return output;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -28,8 +28,10 @@
 #define INCLUDED_FORMAT
 
 #include <algorithm>
+#include <cstddef>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 std::string format (std::string&);
@@ -49,25 +51,55 @@ const std::string format (T value)
     return s.str ();
 }
 
+// Appending each argument of a variadic format, rendered as format (arg)
+// would render it: doubles fixed, other numbers as a stream would.
+void format_append (std::string&, const std::string&);
+void format_append (std::string&, std::string_view);
+void format_append (std::string&, const char*);
+void format_append (std::string&, char);
+void format_append (std::string&, bool);
+void format_append (std::string&, int);
+void format_append (std::string&, unsigned int);
+void format_append (std::string&, long);
+void format_append (std::string&, unsigned long);
+void format_append (std::string&, long long);
+void format_append (std::string&, unsigned long long);
+void format_append (std::string&, float);
+void format_append (std::string&, double);
+
 template<typename T>
-const std::string format (int fmt_num, const std::string& fmt, T arg)
+void format_append (std::string& output, const T& value)
 {
-    std::string output = fmt;
-    replace_positional (output, '{' + format (fmt_num) + '}', format (arg));
-    return output;
+    std::stringstream s;
+    s << value;
+    output += s.str ();
 }
 
-template<typename T, typename... Args>
-const std::string format (int fmt_num, const std::string& fmt, T arg, Args... args)
+// An argument of a variadic format, not yet rendered.
+struct format_argument
+{
+    const void* value;
+    void (*append) (std::string&, const void*);
+};
+
+template<typename T>
+void format_append_argument (std::string& output, const void* value)
 {
-    const std::string fmt_replaced (format (fmt_num, fmt, arg));
-    return format (fmt_num+1, fmt_replaced, args...);
+    format_append (output, *static_cast <const T*> (value));
 }
 
+void format_positional (std::string&, std::string_view, const format_argument*, std::size_t);
+
+// Replaces each {1} to {N} with the corresponding argument.  The format is
+// scanned once, and each argument rendered straight into the output when its
+// placeholder is reached, so nothing is formatted that is not used.
 template<typename... Args>
-const std::string format (const std::string& fmt, Args... args)
+const std::string format (std::string_view fmt, const Args&... args)
 {
-    return format (1, fmt, args...);
+    const format_argument arguments[] = {{&args, &format_append_argument <Args>}..., {nullptr, nullptr}};
+    std::string output;
+    format_positional (output, fmt, arguments, sizeof... (args));
+    return output;
 }
 
 std::string leftJustify (const int, const int);
@@ -84,4 +116,16 @@ std::string printable (char);
 
 std::string obfuscateText (const std::string&);
 
+// Appending forms of the above, which render into the caller's string, with
+// no stream and no temporary string, and so allocate nothing once that string
+// has grown.  Numbers are locale-independent.
+void appendFormat (std::string&, float, int, int);
+void appendFormat (std::string&, double, int, int);
+void appendHex (std::string&, int);
+void appendLeftJustify (std::string&, int, int);
+void appendRightJustifyZero (std::string&, int, int);
+void appendRightJustify (std::string&, int, int);
+void appendCommify (std::string&, std::string_view);
+void appendBytes (std::string&, size_t);
+
 #endif
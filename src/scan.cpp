@@ -0,0 +1,629 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <scan.h>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCAN_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 is not part of the baseline instruction set, so it is compiled per
+// function and only used when the running CPU supports it.
+#if defined (SCAN_SSE2) && (defined (__x86_64__) || defined (__i386__)) && defined (__GNUC__)
+#define SCAN_AVX2
+#define TARGET_AVX2 __attribute__ ((target ("avx2")))
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Index of the lowest set bit, of which there must be one.
+static inline unsigned int lowest_bit (unsigned int mask)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward (&index, mask);
+  return index;
+#else
+  return __builtin_ctz (mask);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static inline unsigned int lowest_bit (uint64_t mask)
+{
+#if defined (_MSC_VER) && defined (_M_X64)
+  unsigned long index;
+  _BitScanForward64 (&index, mask);
+  return index;
+#elif defined (_MSC_VER)
+  return static_cast <uint32_t> (mask) ? lowest_bit (static_cast <unsigned int> (mask))
+                                       : 32 + lowest_bit (static_cast <unsigned int> (mask >> 32));
+#else
+  return __builtin_ctzll (mask);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Each byte class provides a scalar match, and vector matches that return a
+// bitmask with one bit set for each member byte.
+//
+// Unsigned range checks are done as min (v - lo, hi - lo) == v - lo, because
+// SSE2 has no unsigned byte comparison.
+struct AsciiSpace
+{
+  bool match (unsigned char c) const
+  {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+  }
+
+#ifdef SCAN_SSE2
+  unsigned int match (__m128i v) const
+  {
+    auto t = _mm_sub_epi8 (v, _mm_set1_epi8 ('\t'));
+    auto controls = _mm_cmpeq_epi8 (_mm_min_epu8 (t, _mm_set1_epi8 ('\r' - '\t')), t);
+    auto spaces = _mm_cmpeq_epi8 (v, _mm_set1_epi8 (' '));
+    return _mm_movemask_epi8 (_mm_or_si128 (controls, spaces));
+  }
+#endif
+
+#ifdef SCAN_AVX2
+  TARGET_AVX2 unsigned int match (__m256i v) const
+  {
+    auto t = _mm256_sub_epi8 (v, _mm256_set1_epi8 ('\t'));
+    auto controls = _mm256_cmpeq_epi8 (_mm256_min_epu8 (t, _mm256_set1_epi8 ('\r' - '\t')), t);
+    auto spaces = _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (' '));
+    return _mm256_movemask_epi8 (_mm256_or_si256 (controls, spaces));
+  }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+struct AsciiDigit
+{
+  bool match (unsigned char c) const
+  {
+    return c >= '0' && c <= '9';
+  }
+
+#ifdef SCAN_SSE2
+  unsigned int match (__m128i v) const
+  {
+    auto t = _mm_sub_epi8 (v, _mm_set1_epi8 ('0'));
+    return _mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_min_epu8 (t, _mm_set1_epi8 (9)), t));
+  }
+#endif
+
+#ifdef SCAN_AVX2
+  TARGET_AVX2 unsigned int match (__m256i v) const
+  {
+    auto t = _mm256_sub_epi8 (v, _mm256_set1_epi8 ('0'));
+    return _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (_mm256_min_epu8 (t, _mm256_set1_epi8 (9)), t));
+  }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ASCII, but neither whitespace nor NUL.  These bytes are always complete
+// characters, which cannot be Unicode whitespace.
+struct AsciiNonSpace
+{
+  bool match (unsigned char c) const
+  {
+    return c && c < 0x80 && ! AsciiSpace ().match (c);
+  }
+
+#ifdef SCAN_SSE2
+  unsigned int match (__m128i v) const
+  {
+    auto nul = _mm_movemask_epi8 (_mm_cmpeq_epi8 (v, _mm_setzero_si128 ()));
+    auto high = _mm_movemask_epi8 (v);
+    return ~(AsciiSpace ().match (v) | nul | high);
+  }
+#endif
+
+#ifdef SCAN_AVX2
+  TARGET_AVX2 unsigned int match (__m256i v) const
+  {
+    unsigned int nul = _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v, _mm256_setzero_si256 ()));
+    unsigned int high = _mm256_movemask_epi8 (v);
+    return ~(AsciiSpace ().match (v) | nul | high);
+  }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Any byte other than the two delimiters.
+struct Until
+{
+  char _a;
+  char _b;
+
+  bool match (unsigned char c) const
+  {
+    return c != static_cast <unsigned char> (_a) &&
+           c != static_cast <unsigned char> (_b);
+  }
+
+#ifdef SCAN_SSE2
+  unsigned int match (__m128i v) const
+  {
+    auto found = _mm_or_si128 (_mm_cmpeq_epi8 (v, _mm_set1_epi8 (_a)),
+                               _mm_cmpeq_epi8 (v, _mm_set1_epi8 (_b)));
+    return ~_mm_movemask_epi8 (found);
+  }
+#endif
+
+#ifdef SCAN_AVX2
+  TARGET_AVX2 unsigned int match (__m256i v) const
+  {
+    auto found = _mm256_or_si256 (_mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (_a)),
+                                  _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (_b)));
+    return ~static_cast <unsigned int> (_mm256_movemask_epi8 (found));
+  }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Any byte that json::encode leaves as it is: all but " \\ / and the controls
+// \b \t \n \f \r, which are \x08 to \x0d without \v.
+struct JsonPlain
+{
+  bool match (unsigned char c) const
+  {
+    return c != '"' && c != '\\' && c != '/' &&
+           (c < '\b' || c > '\r' || c == '\v');
+  }
+
+#ifdef SCAN_SSE2
+  unsigned int match (__m128i v) const
+  {
+    auto t = _mm_sub_epi8 (v, _mm_set1_epi8 ('\b'));
+    auto controls = _mm_andnot_si128 (_mm_cmpeq_epi8 (v, _mm_set1_epi8 ('\v')),
+                                      _mm_cmpeq_epi8 (_mm_min_epu8 (t, _mm_set1_epi8 ('\r' - '\b')), t));
+    auto found = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (v, _mm_set1_epi8 ('"')),
+                                             _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('\\'))),
+                               _mm_or_si128 (_mm_cmpeq_epi8 (v, _mm_set1_epi8 ('/')), controls));
+    return ~_mm_movemask_epi8 (found);
+  }
+#endif
+
+#ifdef SCAN_AVX2
+  TARGET_AVX2 unsigned int match (__m256i v) const
+  {
+    auto t = _mm256_sub_epi8 (v, _mm256_set1_epi8 ('\b'));
+    auto controls = _mm256_andnot_si256 (_mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('\v')),
+                                         _mm256_cmpeq_epi8 (_mm256_min_epu8 (t, _mm256_set1_epi8 ('\r' - '\b')), t));
+    auto found = _mm256_or_si256 (_mm256_or_si256 (_mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('"')),
+                                                   _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('\\'))),
+                                  _mm256_or_si256 (_mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('/')), controls));
+    return ~static_cast <unsigned int> (_mm256_movemask_epi8 (found));
+  }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ASCII other than NUL.  Each byte is a complete character.
+struct Ascii
+{
+  bool match (unsigned char c) const
+  {
+    return c && c < 0x80;
+  }
+
+#ifdef SCAN_SSE2
+  unsigned int match (__m128i v) const
+  {
+    auto nul = _mm_movemask_epi8 (_mm_cmpeq_epi8 (v, _mm_setzero_si128 ()));
+    return ~(_mm_movemask_epi8 (v) | nul);
+  }
+#endif
+
+#ifdef SCAN_AVX2
+  TARGET_AVX2 unsigned int match (__m256i v) const
+  {
+    unsigned int nul = _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v, _mm256_setzero_si256 ()));
+    unsigned int high = _mm256_movemask_epi8 (v);
+    return ~(high | nul);
+  }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+template <typename Class>
+static std::size_t scan_scalar (
+  const char* data,
+  std::size_t length,
+  std::size_t i,
+  const Class& member)
+{
+  while (i < length && member.match (static_cast <unsigned char> (data[i])))
+    ++i;
+
+  return i;
+}
+
+#ifdef SCAN_SSE2
+////////////////////////////////////////////////////////////////////////////////
+template <typename Class>
+static std::size_t scan_sse2 (
+  const char* data,
+  std::size_t length,
+  const Class& member)
+{
+  std::size_t i = 0;
+  for (; i + 16 <= length; i += 16)
+  {
+    auto v = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (data + i));
+    unsigned int stop = ~member.match (v) & 0xFFFF;
+    if (stop)
+      return i + lowest_bit (stop);
+  }
+
+  return scan_scalar (data, length, i, member);
+}
+#endif
+
+#ifdef SCAN_AVX2
+////////////////////////////////////////////////////////////////////////////////
+template <typename Class>
+TARGET_AVX2 static std::size_t scan_avx2 (
+  const char* data,
+  std::size_t length,
+  const Class& member)
+{
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32)
+  {
+    auto v = _mm256_loadu_si256 (reinterpret_cast <const __m256i*> (data + i));
+    unsigned int stop = ~member.match (v);
+    if (stop)
+      return i + lowest_bit (stop);
+  }
+
+  return scan_scalar (data, length, i, member);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static bool cpu_has_avx2 ()
+{
+  static const bool avx2 = [] ()
+  {
+    __builtin_cpu_init ();
+    return __builtin_cpu_supports ("avx2") != 0;
+  } ();
+
+  return avx2;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+static unsigned int popcount (unsigned int mask)
+{
+  return std::bitset <32> (mask).count ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A continuation byte, 0x80 to 0xBF, is less than -64 as a signed char.
+static std::size_t count_continuation_scalar (
+  const char* data,
+  std::size_t length,
+  std::size_t i)
+{
+  std::size_t count = 0;
+  for (; i < length; ++i)
+    if ((data[i] & 0xC0) == 0x80)
+      ++count;
+
+  return count;
+}
+
+#ifdef SCAN_AVX2
+////////////////////////////////////////////////////////////////////////////////
+TARGET_AVX2 static std::size_t count_continuation_avx2 (
+  const char* data,
+  std::size_t length)
+{
+  std::size_t count = 0;
+  std::size_t i = 0;
+  auto limit = _mm256_set1_epi8 (-64);
+  for (; i + 32 <= length; i += 32)
+  {
+    auto v = _mm256_loadu_si256 (reinterpret_cast <const __m256i*> (data + i));
+    count += popcount (_mm256_movemask_epi8 (_mm256_cmpgt_epi8 (limit, v)));
+  }
+
+  return count + count_continuation_scalar (data, length, i);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+template <typename Class>
+static std::size_t scan (
+  const char* data,
+  std::size_t length,
+  const Class& member)
+{
+  // Most runs are short, so settle the common case before any vector setup.
+  if (length == 0 ||
+      ! member.match (static_cast <unsigned char> (data[0])))
+    return 0;
+
+#ifdef SCAN_AVX2
+  if (length >= 32 && cpu_has_avx2 ())
+    return scan_avx2 (data, length, member);
+#endif
+
+#ifdef SCAN_SSE2
+  return scan_sse2 (data, length, member);
+#else
+  return scan_scalar (data, length, 0, member);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Space, and the controls \t \n \v \f \r.
+std::size_t scan_ascii_space (const char* data, std::size_t length)
+{
+  return scan (data, length, AsciiSpace ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t scan_ascii_digit (const char* data, std::size_t length)
+{
+  return scan (data, length, AsciiDigit ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stops at ASCII whitespace, NUL, or the first byte of a multibyte sequence.
+std::size_t scan_ascii_nonspace (const char* data, std::size_t length)
+{
+  return scan (data, length, AsciiNonSpace ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stops at either delimiter, which may be the same.
+std::size_t scan_until (const char* data, std::size_t length, char a, char b)
+{
+  return scan (data, length, Until {a, b});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stops at NUL, or the first byte of a multibyte sequence.
+std::size_t scan_ascii (const char* data, std::size_t length)
+{
+  return scan (data, length, Ascii ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stops at the first byte that JSON string encoding escapes.
+std::size_t scan_json_plain (const char* data, std::size_t length)
+{
+  return scan (data, length, JsonPlain ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t scan_count_continuation (const char* data, std::size_t length)
+{
+#ifdef SCAN_AVX2
+  if (length >= 32 && cpu_has_avx2 ())
+    return count_continuation_avx2 (data, length);
+#endif
+
+  std::size_t i = 0;
+  std::size_t count = 0;
+
+#ifdef SCAN_SSE2
+  auto limit = _mm_set1_epi8 (-64);
+  for (; i + 16 <= length; i += 16)
+  {
+    auto v = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (data + i));
+    count += popcount (_mm_movemask_epi8 (_mm_cmpgt_epi8 (limit, v)));
+  }
+#endif
+
+  return count + count_continuation_scalar (data, length, i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The JSON structural index works on blocks of 64 bytes, each byte class as a
+// 64-bit mask with bit n for byte n.
+struct JsonBlock
+{
+  uint64_t space;      // space, \t \n \v \f \r
+  uint64_t op;         // { } [ ] : ,
+  uint64_t quote;      // "
+  uint64_t backslash;  // backslash
+  uint64_t nul;        // NUL
+};
+
+////////////////////////////////////////////////////////////////////////////////
+static void classify_scalar (const char* data, JsonBlock& block)
+{
+  block = {0, 0, 0, 0, 0};
+  for (unsigned int i = 0; i < 64; ++i)
+  {
+    uint64_t bit = uint64_t (1) << i;
+    unsigned char c = data[i];
+         if (AsciiSpace ().match (c))        block.space     |= bit;
+    else if (c == '"')                       block.quote     |= bit;
+    else if (c == '\\')                      block.backslash |= bit;
+    else if (c == '\0')                      block.nul       |= bit;
+    else if ((c | 0x20) == '{' ||
+             (c | 0x20) == '}' ||
+             c == ':' || c == ',')           block.op        |= bit;
+  }
+}
+
+#ifdef SCAN_SSE2
+////////////////////////////////////////////////////////////////////////////////
+// '[' and ']' differ from '{' and '}' only by 0x20, so folding that bit in
+// covers all four brackets with two comparisons.
+static void classify_sse2 (const char* data, JsonBlock& block)
+{
+  block = {0, 0, 0, 0, 0};
+  for (unsigned int i = 0; i < 64; i += 16)
+  {
+    auto v = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (data + i));
+    auto folded = _mm_or_si128 (v, _mm_set1_epi8 (0x20));
+    auto op = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (folded, _mm_set1_epi8 ('{')),
+                                          _mm_cmpeq_epi8 (folded, _mm_set1_epi8 ('}'))),
+                            _mm_or_si128 (_mm_cmpeq_epi8 (v, _mm_set1_epi8 (':')),
+                                          _mm_cmpeq_epi8 (v, _mm_set1_epi8 (','))));
+
+    block.space     |= uint64_t (AsciiSpace ().match (v)) << i;
+    block.op        |= uint64_t (_mm_movemask_epi8 (op)) << i;
+    block.quote     |= uint64_t (_mm_movemask_epi8 (_mm_cmpeq_epi8 (v, _mm_set1_epi8 ('"')))) << i;
+    block.backslash |= uint64_t (_mm_movemask_epi8 (_mm_cmpeq_epi8 (v, _mm_set1_epi8 ('\\')))) << i;
+    block.nul       |= uint64_t (_mm_movemask_epi8 (_mm_cmpeq_epi8 (v, _mm_setzero_si128 ()))) << i;
+  }
+}
+#endif
+
+#ifdef SCAN_AVX2
+////////////////////////////////////////////////////////////////////////////////
+TARGET_AVX2 static void classify_avx2 (const char* data, JsonBlock& block)
+{
+  block = {0, 0, 0, 0, 0};
+  for (unsigned int i = 0; i < 64; i += 32)
+  {
+    auto v = _mm256_loadu_si256 (reinterpret_cast <const __m256i*> (data + i));
+    auto folded = _mm256_or_si256 (v, _mm256_set1_epi8 (0x20));
+    auto op = _mm256_or_si256 (_mm256_or_si256 (_mm256_cmpeq_epi8 (folded, _mm256_set1_epi8 ('{')),
+                                                _mm256_cmpeq_epi8 (folded, _mm256_set1_epi8 ('}'))),
+                               _mm256_or_si256 (_mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (':')),
+                                                _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (','))));
+
+    block.space     |= uint64_t (AsciiSpace ().match (v)) << i;
+    block.op        |= uint64_t (static_cast <uint32_t> (_mm256_movemask_epi8 (op))) << i;
+    block.quote     |= uint64_t (static_cast <uint32_t> (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('"'))))) << i;
+    block.backslash |= uint64_t (static_cast <uint32_t> (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('\\'))))) << i;
+    block.nul       |= uint64_t (static_cast <uint32_t> (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v, _mm256_setzero_si256 ())))) << i;
+  }
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Bytes escaped by a backslash.  Backslashes are rare, so they are simply
+// walked in order; each one that is not itself escaped escapes the next byte,
+// which may be in the next block.
+static uint64_t escaped_bytes (uint64_t backslash, bool& carry)
+{
+  uint64_t escaped = carry ? 1 : 0;
+  backslash &= ~escaped;
+  carry = false;
+
+  while (backslash)
+  {
+    auto i = lowest_bit (backslash);
+    if (i == 63)
+    {
+      carry = true;
+      break;
+    }
+
+    escaped   |= uint64_t (1) << (i + 1);
+    backslash &= ~(uint64_t (3) << i);
+  }
+
+  return escaped;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Bit n is set when an odd number of the bits 0..n are set, which for quote
+// positions marks the opening quote and content of every string.
+static uint64_t prefix_xor (uint64_t mask)
+{
+  mask ^= mask << 1;
+  mask ^= mask << 2;
+  mask ^= mask << 4;
+  mask ^= mask << 8;
+  mask ^= mask << 16;
+  mask ^= mask << 32;
+  return mask;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool scan_json_structure (const char* data, std::size_t length, std::vector <uint32_t>& index)
+{
+  void (*classify) (const char*, JsonBlock&) = classify_scalar;
+#ifdef SCAN_SSE2
+  classify = classify_sse2;
+#endif
+#ifdef SCAN_AVX2
+  if (cpu_has_avx2 ())
+    classify = classify_avx2;
+#endif
+
+  // Typical documents have a token every six to eight bytes.
+  index.reserve (index.size () + length / 6);
+
+  bool     escape_carry = false;
+  uint64_t string_carry = 0;   // All ones while inside a string.
+  uint64_t scalar_carry = 0;   // Whether the last byte continues a scalar.
+  uint64_t special      = 0;   // Any backslash or NUL.
+  for (std::size_t base = 0; base < length; base += 64)
+  {
+    JsonBlock block;
+    if (length - base >= 64)
+      classify (data + base, block);
+    else
+    {
+      // Whitespace padding does not change the result.
+      char tail[64];
+      std::memset (tail, ' ', sizeof (tail));
+      std::memcpy (tail, data + base, length - base);
+      classify (tail, block);
+    }
+
+    special |= block.backslash | block.nul;
+    auto quote = block.quote & ~escaped_bytes (block.backslash, escape_carry);
+    auto in_string = prefix_xor (quote) ^ string_carry;
+    string_carry = static_cast <uint64_t> (static_cast <int64_t> (in_string) >> 63);
+
+    auto scalar = ~(block.space | block.op | quote | in_string);
+    auto scalar_start = scalar & ~((scalar << 1) | scalar_carry);
+    scalar_carry = scalar >> 63;
+
+    auto structural = (block.op & ~in_string) | quote | scalar_start;
+    while (structural)
+    {
+      index.push_back (static_cast <uint32_t> (base + lowest_bit (structural)));
+      structural &= structural - 1;
+    }
+  }
+
+  return special != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_SCAN
+#define INCLUDED_SCAN
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Byte-class scanners.  Each returns the length of the leading run of bytes
+// in [data, data + length) that belong to the class, examining 16 or 32
+// bytes per step where the CPU allows.
+std::size_t scan_ascii_space    (const char*, std::size_t);
+std::size_t scan_ascii_digit    (const char*, std::size_t);
+std::size_t scan_ascii_nonspace (const char*, std::size_t);
+std::size_t scan_until          (const char*, std::size_t, char, char);
+std::size_t scan_ascii          (const char*, std::size_t);
+std::size_t scan_json_plain     (const char*, std::size_t);
+
+// Number of UTF-8 continuation bytes (10xxxxxx) anywhere in the range.
+std::size_t scan_count_continuation (const char*, std::size_t);
+
+// JSON structural index.  Appends the offset of every byte that starts a token
+// outside of strings: each of { } [ ] : , and every unescaped quote, opening
+// or closing, and the first byte of any other run of non-whitespace.  String
+// content is not indexed, so the entry after an opening quote is the quote
+// that closes it.  The input must be shorter than 4GB.  Returns whether the
+// input contains any backslash or NUL, without which no string needs more than
+// its quotes to be understood.
+bool scan_json_structure (const char*, std::size_t, std::vector <uint32_t>&);
+
+#endif
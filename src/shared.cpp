@@ -27,9 +27,11 @@
 #include <algorithm>
 #include <cctype>
 #include <cerrno>
+#include <charconv>
 #include <cmake.h>
 #include <cmath>
 #include <csignal>
+#include <cstdlib>
 #include <cstring>
 #include <format.h>
 #include <iostream>
@@ -592,6 +594,32 @@ std::string::size_type find (
   return text.find (pattern, begin);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Converts the whole of text, such as "-1.5e3", to a double.  Where the library
+// supports it, std::from_chars is used, which needs no terminated copy and
+// ignores the locale.  Values out of range are capped, as by strtod.
+bool parseDouble (std::string_view text, double& result)
+{
+  auto first = text.data ();
+  auto last  = first + text.length ();
+  if (first != last && *first == '+')
+    ++first;
+
+#ifdef HAVE_FROM_CHARS_DOUBLE
+  auto converted = std::from_chars (first, last, result);
+  if (converted.ec == std::errc ())
+    return converted.ptr == last;
+
+  if (converted.ec != std::errc::result_out_of_range)
+    return false;
+#endif
+
+  std::string copy (first, last);
+  char* end;
+  result = std::strtod (copy.c_str (), &end);
+  return ! copy.empty () && end == copy.c_str () + copy.length ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string lowerCase (const std::string& input)
 {
@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // shared.cpp, Non-UTF-8 aware.
@@ -50,6 +51,7 @@ bool closeEnough (const std::string&, const std::string&, unsigned int minLength
 int matchLength (const std::string&, const std::string&);
 std::string::size_type find (const std::string&, const std::string&, bool sensitive = true);
 std::string::size_type find (const std::string&, const std::string&, std::string::size_type, bool sensitive = true);
+bool parseDouble (std::string_view, double&);
 
 // List operations.
 template <class T> void listDiff (
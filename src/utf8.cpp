@@ -24,6 +24,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <scan.h>
 #include <utf8.h>
 #include <wcwidth.h>
 
@@ -73,18 +74,37 @@ unsigned int utf8_codepoint (const std::string& input)
 //   - returns the next character
 unsigned int utf8_next_char (const std::string& input, std::string::size_type& i)
 {
-  // Try to recognize end of string without checking length on every call.
-  if (input[i] == '\0') {
-    // If this is not the end of the string, then this is a NUL character
-    // embedded in the string, so advance over it.
-    if (i != input.length()) {
-      i += 1;
-    }
+  return utf8_next_char (std::string_view (input), i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A string_view is not NUL-terminated, so the end of the input is recognized
+// by length, and a truncated sequence is never read beyond the last byte.
+unsigned int utf8_next_char (std::string_view input, std::string::size_type& i)
+{
+  if (i >= input.length ())
+    return 0;
+
+  // ASCII needs no decoding.
+  unsigned char first = input[i];
+  if (first && first < 0x80)
+  {
+    ++i;
+    return first;
+  }
+
+  // An embedded NUL character is advanced over.
+  if (input[i] == '\0')
+  {
+    i += 1;
     return 0;
   }
 
   // How many bytes in the sequence?
   int length = utf8_sequence (input[i]);
+  if (i + length > input.length ())
+    length = 1;
+
   i += length;
 
   // 0xxxxxxx -> 0xxxxxxx
@@ -103,15 +123,10 @@ unsigned int utf8_next_char (const std::string& input, std::string::size_type& i
             (input[i - 1] & 0x3F);
 
   // 11110www 10zzzzzz 10yyyyyy 10xxxxxx -> 000wwwzz zzzzyyyy yyxxxxxx
-  if (length == 4)
-    return ((input[i - 4] & 0x7)  << 18) +
-           ((input[i - 3] & 0x3F) << 12) +
-           ((input[i - 2] & 0x3F) <<  6) +
-            (input[i - 1] & 0x3F);
-
-  // Default: pretend as though it's a single character.
-  // TODO Or should this throw?
-  return input[i - 1];
+  return ((input[i - 4] & 0x7)  << 18) +
+         ((input[i - 3] & 0x3F) << 12) +
+         ((input[i - 2] & 0x3F) <<  6) +
+          (input[i - 1] & 0x3F);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -172,20 +187,9 @@ int utf8_sequence (unsigned int character)
 // Length of a string in characters.
 unsigned int utf8_length (const std::string& str)
 {
-  int byteLength = str.length ();
-  int charLength = byteLength;
-  const char* data = str.data ();
-
-  // Decrement the number of bytes for each byte that matches 0b10??????
-  // this way only the first byte of any utf8 sequence is counted.
-  for (int i = 0; i < byteLength; i++)
-  {
-    // Extract the first two bits and check whether they are 10
-    if ((data[i] & 0xC0) == 0x80)
-      charLength--;
-  }
-
-  return charLength;
+  // Only the first byte of any utf8 sequence is counted, so discount every
+  // byte that matches 0b10??????.
+  return str.length () - scan_count_continuation (str.data (), str.length ());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -195,8 +199,21 @@ unsigned int utf8_width (const std::string& str)
   unsigned int length = 0;
   std::string::size_type i = 0;
   unsigned int c;
-  while ((c = utf8_next_char (str, i)))
+  while (true)
   {
+    // A run of ASCII is measured without decoding: printable characters are
+    // one cell wide, and control characters are zero.
+    if (str[i] > 0)
+    {
+      auto end = i + scan_ascii (str.data () + i, str.length () - i);
+      for (; i < end; ++i)
+        if (str[i] >= 0x20 && str[i] < 0x7F)
+          ++length;
+    }
+
+    if (! (c = utf8_next_char (str, i)))
+      break;
+
     // Control characters, and more especially newline characters, make
     // mk_wcwidth() return -1.  Ignore that, thereby "adding zero" to length.
     // Since control characters are not displayed in reports, this is a valid
@@ -28,9 +28,11 @@
 #define INCLUDED_UTF8
 
 #include <string>
+#include <string_view>
 
 unsigned int utf8_codepoint (const std::string&);
 unsigned int utf8_next_char (const std::string&, std::string::size_type&);
+unsigned int utf8_next_char (std::string_view, std::string::size_type&);
 std::string utf8_character (unsigned int);
 int utf8_sequence (unsigned int);
 unsigned int utf8_length (const std::string&);
@@ -25,8 +25,14 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <Datetime.h>
+#include <DatetimeFormat.h>
+#include <atomic>
+#include <cstdlib>
 #include <ctime>
+#include <format.h>
 #include <iostream>
+#include <thread>
+#include <vector>
 #include <test.h>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -91,7 +97,7 @@ void testParseError (
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (3458);
+  UnitTest t (3523);
 
   Datetime iso;
   std::string::size_type start = 0;
@@ -674,6 +680,17 @@ int main (int, char**)
     t.is (d, 1, "1/1/2008 == 1");
     t.is (y, 2008, "1/1/2008 == 2008");
 
+    // The cached local time follows every change to the date.
+    Datetime moving (2008, 1, 31);
+    t.is (moving.toString ("Y-M-D"), "2008-01-31",  "cached: 2008-01-31");
+    moving += 86400;
+    t.is (moving.toString ("Y-M-D"), "2008-02-01",  "cached: += 86400 -> 2008-02-01");
+    moving._date = Datetime (2009, 7, 4)._date;
+    t.is (moving.toString ("Y-M-D"), "2009-07-04",  "cached: _date assigned -> 2009-07-04");
+    Datetime copied (moving);
+    copied--;
+    t.is (copied.toString ("Y-M-D") + " " + moving.toString ("Y-M-D"), "2009-07-03 2009-07-04", "cached: copy is independent");
+
     Datetime epoch (2001, 9, 8);
     t.ok ((int)epoch.toEpoch () < 1000000000, "9/8/2001 < 1,000,000,000");
     epoch += 172800;
@@ -1398,6 +1415,282 @@ int main (int, char**)
       }
     }
 
+    {
+      // A Context carries its own settings, leaving the statics alone.
+      Datetime::Context sunday;
+      sunday.weekstart = 0;
+      t.notok (Datetime::valid ("2024-W01-7", "", sunday), "Context weekstart=0 --> 2024-W01-7 invalid");
+      t.ok    (Datetime::valid ("2024-W01-7"),             "Datetime::weekstart=1 --> 2024-W01-7 valid");
+      t.is    (Datetime::weekstart, 1,                     "Context leaves Datetime::weekstart alone");
+
+      Datetime::Context strict;
+      strict.isoEnabled = false;
+      t.notok (Datetime::valid ("20170319", "", strict),   "Context isoEnabled=false --> 20170319 invalid");
+
+      // Formatting uses the settings the date was made with.
+      Datetime monday ("2024-01-08", "Y-M-D", sunday);
+      t.is (monday.week (), 1,                              "Context weekstart=0 --> 2024-01-08 week 1");
+      t.is (Datetime ("2024-01-08", "Y-M-D").week (), 2,    "Datetime::weekstart=1 --> 2024-01-08 week 2");
+      t.is ((monday + 86400).week (), 1,                    "Datetime + 86400 keeps its Context");
+
+      t.is (Datetime::monthOfYear ("janu", 0), 1,           "monthOfYear ('janu', 0) --> 1");
+      t.is (Datetime::dayOfWeek ("mo", 2), 1,               "dayOfWeek ('mo', 2) --> 1");
+      t.is (Datetime::dayOfWeek ("mo", 0), -1,              "dayOfWeek ('mo', 0) --> -1");
+
+      // Threads parse and format in parallel, each with its own Context, and
+      // agree with the same work done serially.
+      std::vector <std::string> inputs;
+      for (int i = 0; i < 2000; ++i)
+        inputs.push_back (format ("{1}-W{2}-{3}T{4}:{5}:00Z",
+                                  2000 + i % 30, 10 + i % 43, 1 + i % 6, 10 + i % 14, 10 + i % 50));
+
+      std::vector <std::string> expected[2];
+      for (int wks = 0; wks < 2; ++wks)
+      {
+        Datetime::Context context;
+        context.weekstart = wks;
+        for (auto& input : inputs)
+        {
+          Datetime date (input, "", context);
+          expected[wks].push_back (date.toISO () + date.toString (" Y-M-D H:N:S"));
+        }
+      }
+
+      std::atomic <int> mismatches {0};
+      std::vector <std::thread> threads;
+      for (int thread = 0; thread < 4; ++thread)
+        threads.emplace_back ([&, thread] ()
+        {
+          Datetime::Context context;
+          context.weekstart = thread % 2;
+          for (int repeat = 0; repeat < 5; ++repeat)
+            for (std::size_t i = 0; i < inputs.size (); ++i)
+            {
+              Datetime date (inputs[i], "", context);
+              if (date.toISO () + date.toString (" Y-M-D H:N:S") != expected[thread % 2][i])
+                ++mismatches;
+            }
+        });
+
+      for (auto& thread : threads)
+        thread.join ();
+
+      t.is (mismatches.load (), 0, "Datetime parses and formats in parallel threads");
+    }
+
+    {
+      // Civil dates by arithmetic, and their agreement with libc.
+      t.is ((int) Datetime::daysFromCivil (1970, 1, 1), 0,                 "daysFromCivil (1970, 1, 1) --> 0");
+      t.is ((int) Datetime::daysFromCivil (2000, 3, 1), 11017,             "daysFromCivil (2000, 3, 1) --> 11017");
+      t.is ((int) Datetime::daysFromCivil (1969, 12, 31), -1,              "daysFromCivil (1969, 12, 31) --> -1");
+      t.is ((int) Datetime::daysFromCivil (2024, 2, 30),
+            (int) Datetime::daysFromCivil (2024, 3, 1),                    "daysFromCivil (2024, 2, 30) --> 2024-03-01");
+
+      // The length of the month is by arithmetic too, as daysInMonth only
+      // takes years from 1969.
+      int wrong = 0;
+      for (int days = -800000; days <= 800000; ++days)
+      {
+        int y, m, d;
+        Datetime::civilFromDays (days, y, m, d);
+        auto length = Datetime::daysFromCivil (m == 12 ? y + 1 : y, m % 12 + 1, 1) - Datetime::daysFromCivil (y, m, 1);
+        if (Datetime::daysFromCivil (y, m, d) != days || d < 1 || d > length)
+          ++wrong;
+      }
+      t.is (wrong, 0, "civilFromDays inverts daysFromCivil over 4000 years");
+
+      // Noon is never skipped or repeated by a change to summer time.
+      wrong = 0;
+      for (int days = 0; days < 24800; days += 3)
+      {
+        int y, m, d;
+        Datetime::civilFromDays (days, y, m, d);
+
+        struct tm noon {};
+        noon.tm_isdst = -1;
+        noon.tm_year  = y - 1900;
+        noon.tm_mon   = m - 1;
+        noon.tm_mday  = d;
+        noon.tm_hour  = 12;
+        if (Datetime (y, m, d, 12, 0, 0).toEpoch () != mktime (&noon))
+          ++wrong;
+      }
+      t.is (wrong, 0, "Datetime (y, m, d, 12, 0, 0) agrees with mktime, 1970-2037");
+
+      // A new thread has no offset from earlier conversions to start from,
+      // and must still find the right one for every hour of a change to
+      // summer time, the skipped hour included.  Each hour is the first
+      // conversion on its thread.
+      auto saved = getenv ("TZ");
+      std::string original = saved ? saved : "";
+      for (auto zone : {"America/New_York", "America/Los_Angeles"})
+      {
+        setenv ("TZ", zone, 1);
+        tzset ();
+
+        wrong = 0;
+        for (int hour = 0; hour < 24; ++hour)
+        {
+          std::thread fresh ([&wrong, hour] ()
+          {
+            struct tm when {};
+            when.tm_isdst = -1;
+            when.tm_year  = 2023 - 1900;
+            when.tm_mon   = 2;
+            when.tm_mday  = 12;
+            when.tm_hour  = hour;
+            when.tm_min   = 30;
+            if (Datetime (2023, 3, 12, hour, 30, 0).toEpoch () != mktime (&when))
+              ++wrong;
+          });
+          fresh.join ();
+        }
+
+        t.is (wrong, 0, std::string ("Datetime (2023, 3, 12, h, 30, 0) on a new thread agrees with mktime, ") + zone);
+      }
+
+      if (saved)
+        setenv ("TZ", original.c_str (), 1);
+      else
+        unsetenv ("TZ");
+      tzset ();
+
+      t.is (Datetime ("2024-02-29T12:00:00Z").toEpoch (), (time_t) 1709208000,  "2024-02-29T12:00:00Z --> 1709208000");
+      t.is (Datetime ((time_t) -1).toISO (), "19691231T235959Z",           "Datetime (-1).toISO () --> 19691231T235959Z");
+    }
+
+    {
+      // A DatetimeFormat renders and parses as its format string does.
+      DatetimeFormat iso ("Y-M-DTH:N:S");
+      DatetimeFormat all ("m M d D y Y a A b B v V h H n N s S j J w");
+      Datetime late ("2015-10-28T12:55:01");
+      Datetime early (2009, 2, 3, 4, 5, 6);
+
+      t.is (late.toString (iso), "2015-10-28T12:55:01",               "DatetimeFormat Y-M-DTH:N:S --> 2015-10-28T12:55:01");
+      t.is (iso.render (early), early.toString ("Y-M-DTH:N:S"),       "DatetimeFormat render == toString (string)");
+      t.is (all.render (early),
+            "2 02 3 03 09 2009 Tue Tuesday Feb February 6 06 4 04 5 05 6 06 34 034 2",
+                                                                      "DatetimeFormat renders every field");
+      t.is (all.render (early), early.toString (all.str ()),         "DatetimeFormat every field == toString (string)");
+      t.ok (all.render (early).length () <= all.capacity (),         "DatetimeFormat capacity bounds render");
+
+      std::string column = "> ";
+      iso.render (late, column);
+      column += '\n';
+      iso.render (early, column);
+      t.is (column, "> 2015-10-28T12:55:01\n2009-02-03T04:05:06",     "DatetimeFormat render appends");
+
+      char buffer[32];
+      auto length = iso.render (late, buffer);
+      t.is (std::string (buffer, length), "2015-10-28T12:55:01",     "DatetimeFormat render (char*)");
+
+      Datetime::Context context;
+      t.is (Datetime ("2009-02-03T04:05:06", iso, context).toEpoch (), early.toEpoch (),
+                                                                      "Datetime (input, DatetimeFormat) parses");
+      t.is (Datetime ("Tuesday 3 February 2009", DatetimeFormat ("A d B Y"), context).toString (iso),
+            "2009-02-03T00:00:00",                                    "DatetimeFormat A d B Y parses names");
+
+      DatetimeFormat dmy ("D/M/Y");
+      Datetime parsed;
+      std::string::size_type start = 0;
+      t.ok    (parsed.parse ("03/02/2009", start, dmy, context),   "DatetimeFormat D/M/Y parses 03/02/2009");
+      t.is    (parsed.toString (iso), "2009-02-03T00:00:00",         "DatetimeFormat D/M/Y 03/02/2009 --> 2009-02-03");
+      start = 0;
+      t.notok (parsed.parse ("03/02/20xx", start, dmy, context),   "DatetimeFormat D/M/Y rejects 03/02/20xx");
+      t.ok    (DatetimeFormat ("").empty (),                         "DatetimeFormat ('') is empty");
+    }
+
+    {
+      // The compact UTC form has a parser of its own, which must agree with
+      // the general grammar, here reached through the extended form.
+      t.is (Datetime ("20231017T083000Z").toEpoch (), (time_t) 1697531400, "20231017T083000Z --> 1697531400");
+      t.is (Datetime ((time_t) 1697531400).toISO (), "20231017T083000Z",  "1697531400 --> 20231017T083000Z");
+
+      int wrong = 0;
+      for (time_t when = 0; when < 4102444800; when += 86400 * 3 + 3607)
+      {
+        auto compact  = Datetime (when).toISO ();
+        auto extended = compact.substr (0, 4) + '-' + compact.substr (4, 2) + '-' + compact.substr (6, 5) + ':' +
+                        compact.substr (11, 2) + ':' + compact.substr (13);
+        if (Datetime (compact).toEpoch () != when || Datetime (extended).toEpoch () != when)
+          ++wrong;
+      }
+      t.is (wrong, 0, "YYYYMMDDThhmmssZ agrees with YYYY-MM-DDThh:mm:ssZ, 1970-2099");
+
+      Datetime compact;
+      std::string::size_type start = 0;
+      t.ok (compact.parse ("20240229T235959Z and more", start),       "20240229T235959Z and more --> parsed");
+      t.is ((int) start, 16,                                          "20240229T235959Z and more --> start 16");
+      t.is (compact._year * 10000 + compact._month * 100 + compact._day, 20240229,
+                                                                      "20240229T235959Z --> _year, _month, _day");
+      t.is (compact._seconds, 86399,                                  "20240229T235959Z --> _seconds 86399");
+      t.ok (compact._utc,                                             "20240229T235959Z --> _utc");
+
+      t.notok (Datetime::valid ("20230229T000000Z"),                  "20230229T000000Z --> invalid");
+      t.notok (Datetime::valid ("20231317T083000Z"),                  "20231317T083000Z --> invalid");
+      t.notok (Datetime::valid ("19691231T235959Z"),                  "19691231T235959Z --> invalid, as parse_year requires");
+      start = 0;
+      t.ok (compact.parse ("20231017T083000Z1", start) && start == 15,
+                                                                      "20231017T083000Z1 --> local, by the general grammar");
+      t.is (Datetime ("20231017T0830Z").toEpoch (), (time_t) 1697531400, "20231017T0830Z --> 1697531400, by the general grammar");
+    }
+
+    {
+      // A column parses as each of its dates would alone, whichever form is
+      // favoured, and with any number of threads.
+      std::vector <std::string> compact;
+      std::vector <std::string> extended;
+      std::vector <time_t> expected;
+      for (time_t when = 946684800; compact.size () < 20000; when += 86400 + 3607)
+      {
+        compact.push_back (Datetime (when).toISO ());
+        extended.push_back (Datetime (when).toISOLocalExtended ());
+        expected.push_back (when);
+      }
+
+      compact[17]  = "20230230T000000Z";
+      extended[17] = "2023-10-17";
+      extended[18] = "1234567890";
+      extended[19] = "2023-10-17T08:30:00Z";
+
+      std::vector <time_t> times;
+      std::vector <bool> failed;
+      t.is ((int) Datetime::parseColumn (compact, times, failed), 1,  "parseColumn compact --> 1 failed");
+      t.ok (failed[17] && ! failed[16] && times[17] == 0,              "parseColumn compact --> 20230230T000000Z failed");
+
+      int wrong = 0;
+      for (std::size_t i = 0; i < compact.size (); ++i)
+        if (i != 17 && times[i] != expected[i])
+          ++wrong;
+      t.is (wrong, 0,                                                  "parseColumn compact --> all others agree");
+
+      std::vector <time_t> threaded;
+      std::vector <bool> threadedFailed;
+      Datetime::parseColumn (compact, threaded, threadedFailed, "", Datetime::Context (), 4);
+      t.ok (threaded == times && threadedFailed == failed,            "parseColumn compact, 4 threads --> same");
+
+      t.is ((int) Datetime::parseColumn (extended, times, failed), 0, "parseColumn extended --> 0 failed");
+      wrong = 0;
+      for (std::size_t i = 0; i < extended.size (); ++i)
+        if (times[i] != Datetime (extended[i]).toEpoch ())
+          ++wrong;
+      t.is (wrong, 0,                                                  "parseColumn extended --> each agrees with Datetime (input)");
+      t.is (times[19], (time_t) 1697531400,                            "parseColumn extended --> 2023-10-17T08:30:00Z is UTC");
+
+      std::vector <std::string_view> views {"junk", "2024-02-29", "20240229T120000Z", "", "1709208000"};
+      t.is ((int) Datetime::parseColumn (views, times, failed), 2,    "parseColumn string_view --> 2 failed");
+      t.ok (failed[0] && ! failed[1] && ! failed[2] && failed[3] && ! failed[4],
+                                                                       "parseColumn string_view --> junk and '' failed");
+      t.is (times[1], Datetime ("2024-02-29").toEpoch (),              "parseColumn string_view --> 2024-02-29");
+      t.is (times[2], (time_t) 1709208000,                             "parseColumn string_view --> 20240229T120000Z");
+      t.is (times[4], (time_t) 1709208000,                             "parseColumn string_view --> 1709208000");
+
+      std::vector <std::string> dmy {"03/02/2009", "20090203T000000Z", "31/12/2009"};
+      t.is ((int) Datetime::parseColumn (dmy, times, failed, "D/M/Y"), 0, "parseColumn D/M/Y --> 0 failed");
+      t.ok (times[0] == Datetime (2009, 2, 3).toEpoch () && times[2] == Datetime (2009, 12, 31).toEpoch (),
+                                                                       "parseColumn D/M/Y --> 2009-02-03, 2009-12-31");
+    }
+
     // This is just a diagnostic dump of all named dates, and is used to verify
     // correctness manually.
     t.diag ("--------------------------------------------");
@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Timer.h>
+#include <Datetime.h>
+#include <DatetimeFormat.h>
+#include <Timezone.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Makes count dates, and reports the rate in millions per second, and the
+// time per date.
+template <typename F>
+static void measure (const std::string& name, long count, F function)
+{
+  long long sink = 0;
+
+  Timer timer;
+  for (long i = 0; i < count; ++i)
+    sink += function (i);
+  timer.stop ();
+
+  double seconds = timer.total_us () / 1e6;
+  std::cout << std::left  << std::setw (42) << name
+            << std::right << std::setw (8) << std::fixed << std::setprecision (2)
+            << count / seconds / 1e6 << " M/s"
+            << std::setw (10) << std::setprecision (1) << seconds * 1e9 / count << " ns"
+            << "  (" << sink << ")\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Usage: datetime_bench [count]
+//
+// Parsing is slower than construction, and is measured over a tenth of count.
+int main (int argc, char** argv)
+{
+  long count = argc > 1 ? std::atol (argv[1]) : 10000000;
+
+  // Dates spread over thirty years, so that both summer and winter time, and
+  // leap years, are covered.
+  auto year  = [] (long i) { return 2000 + (int) (i % 30); };
+  auto month = [] (long i) { return 1 + (int) (i / 30 % 12); };
+  auto day   = [] (long i) { return 1 + (int) (i / 360 % 28); };
+
+  measure ("Datetime (y, m, d)", count, [&] (long i)
+  {
+    return Datetime (year (i), month (i), day (i)).toEpoch ();
+  });
+
+  measure ("Datetime (y, m, d, h, n, s)", count, [&] (long i)
+  {
+    return Datetime (year (i), month (i), day (i), i % 24, i % 60, i % 59).toEpoch ();
+  });
+
+  measure ("Datetime::startOfDay", count, [] (long i)
+  {
+    return Datetime ((time_t) (946684800 + i * 7919 % 946080000)).startOfDay ().toEpoch ();
+  });
+
+  std::vector <std::string> inputs[4];
+  for (long i = 0; i < 1000; ++i)
+  {
+    Datetime date (year (i), month (i), day (i), i % 24, i % 60, i % 59);
+    auto text = date.toISOLocalExtended ();
+    inputs[0].push_back (text);
+    inputs[1].push_back (text + "Z");
+    inputs[2].push_back (text + "+01:00");
+    inputs[3].push_back (date.toISO ());
+  }
+
+  const char* names[4] = {"Datetime (\"Y-M-DTH:N:S\")",
+                          "Datetime (\"Y-M-DTH:N:SZ\")",
+                          "Datetime (\"Y-M-DTH:N:S+01:00\")",
+                          "Datetime (\"YMDTHNSZ\")"};
+  for (int kind = 0; kind < 4; ++kind)
+    measure (names[kind], count / 10, [&inputs, kind] (long i)
+    {
+      return Datetime (inputs[kind][i % 1000]).toEpoch ();
+    });
+
+  // Whole columns of a thousand, as from an import or a data file, reported
+  // per column.
+  std::vector <time_t> times;
+  std::vector <bool> failed;
+  const char* columns[2] = {"Datetime::parseColumn (1000 Y-M-DTH:N:S)",
+                            "Datetime::parseColumn (1000 YMDTHNSZ)"};
+  for (int kind = 0; kind < 2; ++kind)
+    measure (columns[kind], count / 10000, [&inputs, &times, &failed, kind] (long)
+    {
+      Datetime::parseColumn (inputs[kind * 3], times, failed);
+      return times.back ();
+    });
+
+  measure ("Datetime::toISO", count / 10, [] (long i)
+  {
+    return Datetime ((time_t) (946684800 + i * 7919 % 946080000)).toISO ().length ();
+  });
+
+  // Rendering and parsing with an explicit format, by its string, and by a
+  // DatetimeFormat compiled once.
+  measure ("Datetime::toString (\"Y-M-DTH:N:S\")", count / 10, [] (long i)
+  {
+    return Datetime ((time_t) (946684800 + i * 7919 % 946080000)).toString ("Y-M-DTH:N:S").length ();
+  });
+
+  DatetimeFormat format ("Y-M-DTH:N:S");
+  std::string column;
+  measure ("DatetimeFormat::render", count / 10, [&format, &column] (long i)
+  {
+    column.clear ();
+    format.render (Datetime ((time_t) (946684800 + i * 7919 % 946080000)), column);
+    return column.length ();
+  });
+
+  measure ("Datetime (input, \"Y-M-DTH:N:S\")", count / 10, [&inputs] (long i)
+  {
+    return Datetime (inputs[0][i % 1000], "Y-M-DTH:N:S").toEpoch ();
+  });
+
+  Datetime::Context settings;
+  measure ("Datetime (input, DatetimeFormat)", count / 10, [&inputs, &format, &settings] (long i)
+  {
+    return Datetime (inputs[0][i % 1000], format, settings).toEpoch ();
+  });
+
+  // The same conversions through the tz database, one at a time and in bulk.
+  try
+  {
+    auto& berlin = Timezone::get ("Europe/Berlin");
+    auto when = [] (long i) { return (time_t) (946684800 + i * 7919 % 946080000); };
+
+    measure ("Timezone::toLocal", count, [&] (long i)
+    {
+      return berlin.toLocal (when (i));
+    });
+
+    measure ("Timezone::toUTC", count, [&] (long i)
+    {
+      return berlin.toUTC (when (i));
+    });
+
+    // Batches of a thousand sorted times, as from a log or a table column,
+    // reported per batch.
+    std::vector <time_t> times (1000);
+    std::vector <int64_t> locals;
+    measure ("Timezone::toLocal (1000 sorted)", count / 1000, [&] (long i)
+    {
+      for (long j = 0; j < 1000; ++j)
+        times[j] = 946684800 + (i * 1000 + j) * 97;
+
+      berlin.toLocal (times, locals);
+      return locals.back ();
+    });
+
+    Datetime::Context context;
+    context.timezone = &berlin;
+    measure ("Datetime (\"Y-M-DTH:N:S\") in a zone", count / 10, [&inputs, &context] (long i)
+    {
+      return Datetime (inputs[0][i % 1000], "", context).toEpoch ();
+    });
+  }
+
+  catch (const std::string& error)
+  {
+    std::cout << error << '\n';
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
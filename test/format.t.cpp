@@ -25,12 +25,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <format.h>
+#include <string_view>
 #include <test.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (79);
+  UnitTest t (92);
 
   // std::string format (char);
   t.is (format ('A'), "A", "format ('A') -> A");
@@ -71,6 +72,21 @@ int main (int, char**)
   t.is (format ("pre {1}{2}{3} post", "one", "two", "three"), "pre onetwothree post", "format 3a");
   t.is (format ("pre {3}{1}{2} post", "one", "two", "three"), "pre threeonetwo post", "format 3b");
 
+  // Arguments render as format (arg) does, doubles fixed and floats as %g.
+  std::string text = "text";
+  t.is (format ("{1} {2} {3} {4}", text, std::string_view ("view"), 'c', true), "text view c 1", "format strings, char, bool");
+  t.is (format ("{1} {2}", -9223372036854775807LL - 1, 18446744073709551615ULL),
+                                                  "-9223372036854775808 18446744073709551615", "format 64-bit limits");
+  t.is (format ("{1} {2} {3}", 1.5, 0.1 + 0.2, 1.5f), "1.500000 0.300000 1.5", "format double, float");
+  t.is (format ("{1}", 1e300).length (), (size_t) 308,                          "format 1e300 fixed");
+  t.is (format ("{1}", (short) 7),                "7",               "format short");
+
+  // Only {1} to {N} are placeholders, and arguments are not themselves scanned.
+  t.is (format ("{0}{3}{01}{1}{", "a", "b"),      "{0}{3}{01}a{",    "format {0}, {3}, {01}, unclosed");
+  t.is (format ("{1}{2}", "{2}", "x"),            "{2}x",            "format argument containing {2}");
+  t.is (format ("{10}{1}", 1, 2, 3, 4, 5, 6, 7, 8, 9, "ten"), "ten1", "format {10}");
+  t.is (format (std::string ("{1}"), text),       "text",            "format std::string format");
+
   // std::string leftJustify (const std::string&, const int);
   t.is (leftJustify (123, 3), "123",   "leftJustify 123,3 -> '123'");
   t.is (leftJustify (123, 4), "123 ",  "leftJustify 123,4 -> '123 '");
@@ -128,6 +144,21 @@ int main (int, char**)
   t.is (formatBytes (1000000000), "1.0 GiB", "1000000000 -> 1.0 GiB");
   t.is (formatBytes (1000000001), "1.0 GiB", "1000000001 -> 1.0 GiB");
 
+  // Appending forms, which add to what the string already holds.
+  std::string row = "|";
+  appendFormat (row, 2444238.56789, 12, 11);
+  appendHex (row, -1);
+  appendRightJustifyZero (row, -42, 5);
+  appendRightJustify (row, 7, 3);
+  appendLeftJustify (row, 7, 3);
+  appendCommify (row, "1234567.891");
+  appendBytes (row, 12345678901234ULL);
+  t.is (row, "|2444238.5679ffffffff00-42  77  1,234,567.89112,345.7 GiB", "append* into one row");
+
+  t.is (formatBytes (12345678901234ULL), "12,345.7 GiB", "12345678901234 -> 12,345.7 GiB");
+  t.is (format (1e-9, 10, 3),            "         0",   "format (1e-9,         10,   3) -> _________0");
+  t.is (format (1234567.0, 4, 3),        "1.23e+06",     "format (1234567.0,     4,   3) -> 1.23e+06");
+
   // std::string printable (const std::string&);
   t.is (printable ("f\ro\no\tb\va\vr"), "f\\ro\\no\\tb\\va\\vr", "printable f\\ro\\no\\tb\\va\\vr --> f\\\\ro\\\\no\\\\tb\\\\va\\\\vr");
   t.is (printable ("foobar"),           "foobar",                "printable foobar --> foobar");
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Timer.h>
+#include <format.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+////////////////////////////////////////////////////////////////////////////////
+// Formats count numbers, and reports the rate in millions per second, and the
+// time per number.
+template <typename F>
+static void measure (const std::string& name, long count, F function)
+{
+  unsigned long long sink = 0;
+
+  Timer timer;
+  for (long i = 0; i < count; ++i)
+    sink += function (i);
+  timer.stop ();
+
+  double seconds = timer.total_us () / 1e6;
+  std::cout << std::left  << std::setw (36) << name
+            << std::right << std::setw (8) << std::fixed << std::setprecision (1)
+            << count / seconds / 1e6 << " M/s"
+            << std::setw (8) << seconds * 1e9 / count << " ns"
+            << "  (" << sink << ")\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Usage: format_bench [count]
+int main (int argc, char** argv)
+{
+  long count = argc > 1 ? std::atol (argv[1]) : 10000000;
+
+  // Values as found in report columns: urgencies, ids and sizes.
+  auto real = [] (long i) { return (double) (i % 100000) / 997.0; };
+
+  // Appending forms render into one buffer, emptied as a row would be.
+  std::string buffer;
+  auto append = [&buffer] (auto render)
+  {
+    if (buffer.length () > 4096)
+      buffer.clear ();
+
+    auto before = buffer.length ();
+    render (buffer);
+    return buffer.length () - before;
+  };
+
+  measure ("std::stringstream (reference)", count, [&real] (long i)
+  {
+    std::stringstream s;
+    s.width (8);
+    s.precision (4);
+    s << real (i);
+    return s.str ().length ();
+  });
+
+  measure ("format (double, int, int)", count, [&real] (long i)
+  {
+    return format (real (i), 8, 4).length ();
+  });
+
+  measure ("appendFormat (double, int, int)", count, [&] (long i)
+  {
+    return append ([&] (std::string& out) { appendFormat (out, real (i), 8, 4); });
+  });
+
+  measure ("rightJustify (int, int)", count, [] (long i)
+  {
+    return rightJustify ((int) i, 8).length ();
+  });
+
+  measure ("appendRightJustify (int, int)", count, [&] (long i)
+  {
+    return append ([i] (std::string& out) { appendRightJustify (out, (int) i, 8); });
+  });
+
+  measure ("formatHex (int)", count, [] (long i)
+  {
+    return formatHex ((int) i).length ();
+  });
+
+  measure ("appendHex (int)", count, [&] (long i)
+  {
+    return append ([i] (std::string& out) { appendHex (out, (int) i); });
+  });
+
+  std::string digits = "1234567890";
+  measure ("commify (std::string)", count, [&digits] (long)
+  {
+    return commify (digits).length ();
+  });
+
+  measure ("appendCommify (std::string_view)", count, [&] (long)
+  {
+    return append ([&digits] (std::string& out) { appendCommify (out, digits); });
+  });
+
+  measure ("formatBytes (size_t)", count, [] (long i)
+  {
+    return formatBytes ((size_t) i * 7919).length ();
+  });
+
+  measure ("appendBytes (size_t)", count, [&] (long i)
+  {
+    return append ([i] (std::string& out) { appendBytes (out, (size_t) i * 7919); });
+  });
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
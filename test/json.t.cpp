@@ -25,7 +25,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <JSON.h>
+#include <algorithm>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <test.h>
@@ -100,6 +102,38 @@ const char *negative_tests[] =
 
 #define NUM_NEGATIVE_TESTS (sizeof (negative_tests) / sizeof (negative_tests[0]))
 
+const char *stream_tests[] =
+{
+  "[1,-2,3.5,1e3,-0.5E-2,18446744073709551615,99999999999999999999]",
+  "{\"a\":\"x\\u20acy\\uZZ\\\"\\n\", \"b\" : [ true , false , null , [ ] , { } ] }",
+  "[1,]",
+  "[1 2]",
+  "[tru]",
+  "[1.]",
+  "[-]",
+  "{\"a\" 1}",
+  "[\"unterminated]",
+  "[] []",
+};
+
+#define NUM_STREAM_TESTS (sizeof (stream_tests) / sizeof (stream_tests[0]))
+
+const char *indexed_tests[] =
+{
+  "[1 .5]",
+  "[truex]",
+  "[1x]",
+  "{\"a\\\"b\":\"c\\\\\"}",
+  "[\"a\\u0041\", 12345678901234567890123, -0, 1E+2]",
+  "  [  {  \"k\"  :  [  ]  }  ,  nullx  ]  ",
+  "{\"a\":1,}",
+  "{\"a\":1,\"b\"}",
+  "[\"x\" \"y\"]",
+  "[\"\\",
+};
+
+#define NUM_INDEXED_TESTS (sizeof (indexed_tests) / sizeof (indexed_tests[0]))
+
 std::stringstream combined;
 class EventSink : public json::SAX::Sink
 {
@@ -119,6 +153,13 @@ public:
   void eventValueString (const std::string& value) override { combined << "<string>" << value << "</string>"; }
 };
 
+class ViewEventSink : public json::SAX::ViewSink
+{
+public:
+  void eventName (std::string_view value) override        { combined << "<name>"   << value << "</name>";   }
+  void eventValueString (std::string_view value) override { combined << "<string>" << value << "</string>"; }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 void saxTest (UnitTest& t, const std::string& input, const std::string& expected)
 {
@@ -134,10 +175,163 @@ void saxTest (UnitTest& t, const std::string& input, const std::string& expected
   catch (...)                  { t.fail ("Unknown error"); }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Feeds the input to a SAX::Stream in chunks of the given size, and expects the
+// same events, or the same failure, as SAX::parse.
+void streamTest (UnitTest& t, const std::string& input, std::size_t chunk)
+{
+  std::string expected;
+  try
+  {
+    combined.str (std::string ());
+    EventSink sink;
+    json::SAX sax;
+    sax.parse (input, sink);
+    expected = combined.str ();
+  }
+
+  catch (const std::string&) { expected = "<error>"; }
+
+  std::string actual;
+  try
+  {
+    combined.str (std::string ());
+    EventSink sink;
+    json::SAX::Stream stream (sink);
+    for (std::size_t i = 0; i < input.length (); i += chunk)
+      stream.feed (input.data () + i, std::min (chunk, input.length () - i));
+
+    stream.finish ();
+    actual = combined.str ();
+  }
+
+  catch (const std::string&) { actual = "<error>"; }
+
+  t.is (actual, expected, "stream: chunk " + std::to_string (chunk) + " '" + input + "'");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Parses the input with SAX::parseIndexed, and expects the same events, or the
+// same error, as SAX::parse.
+void indexedTest (UnitTest& t, const std::string& input)
+{
+  std::string expected;
+  try
+  {
+    combined.str (std::string ());
+    EventSink sink;
+    json::SAX sax;
+    sax.parse (input, sink);
+    expected = combined.str ();
+  }
+
+  catch (const std::string& e) { expected = combined.str () + "<error>" + e; }
+
+  std::string actual;
+  try
+  {
+    combined.str (std::string ());
+    EventSink sink;
+    json::SAX sax;
+    sax.parseIndexed (input, sink);
+    actual = combined.str ();
+  }
+
+  catch (const std::string& e) { actual = combined.str () + "<error>" + e; }
+
+  t.is (actual, expected, "indexed: '" + input + "'");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Renders a lazy element as json::document would dump it.
+void lazyWrite (json::Writer& writer, const json::lazy_element& e)
+{
+  switch (e.type ())
+  {
+  case json::j_string:
+    writer.encodedValue (e.str ());
+    break;
+
+  case json::j_number:
+         if (e.kind () == json::number::intvalue)  writer.value (e.ivalue ());
+    else if (e.kind () == json::number::uintvalue) writer.value (e.uvalue ());
+    else                                           writer.value (e.number ());
+    break;
+
+  case json::j_literal:
+    if (e.lvalue () == json::literal::nullvalue)
+      writer.null ();
+    else
+      writer.value (e.lvalue () == json::literal::truevalue);
+    break;
+
+  case json::j_array:
+    writer.beginArray ();
+    for (auto child : e)
+      lazyWrite (writer, child);
+    writer.endArray ();
+    break;
+
+  case json::j_object:
+    writer.beginObject ();
+    for (auto i = e.begin (); i != e.end (); ++i)
+    {
+      writer.encodedKey (i.key ());
+      lazyWrite (writer, *i);
+    }
+    writer.endObject ();
+    break;
+
+  case json::j_value:
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void lazyTest (UnitTest& t, const std::string& input)
+{
+  std::string expected;
+  try
+  {
+    expected = json::document (input).dump ();
+  }
+
+  catch (const std::string&) { expected = "<error>"; }
+
+  std::string actual;
+  try
+  {
+    json::lazy_document doc (input);
+    json::Writer writer (actual);
+    lazyWrite (writer, doc.root ());
+  }
+
+  catch (const std::string&) { actual = "<error>"; }
+
+  t.is (actual, expected, "lazy: '" + input + "'");
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (NUM_POSITIVE_TESTS + NUM_NEGATIVE_TESTS + 31 + 4);
+  // The plan, in the order of the sections below.
+  UnitTest t (NUM_POSITIVE_TESTS + NUM_NEGATIVE_TESTS                                     // Positive and negative tests
+            + NUM_POSITIVE_TESTS + NUM_NEGATIVE_TESTS                                     // Arena document
+            + 31                                                                          // Other tests
+            + 3                                                                           // Other tests: encode and decode
+            + 13                                                                          // Object members
+            + 15 + 1                                                                      // Arena document accessors, large documents
+            + 13                                                                          // Numbers
+            + NUM_POSITIVE_TESTS + 18 + 7                                                 // Lazy documents
+            + 8 + 2                                                                       // Lazy errors
+            + 10 + 4                                                                      // JSON Lines
+            + 13 + 4                                                                      // Owned nodes
+            + NUM_POSITIVE_TESTS                                                          // Converting to nodes
+            + 5                                                                           // Writer
+            + 4                                                                           // SAX tests
+            + 2                                                                           // SAX with string_view
+            + 3 * (NUM_POSITIVE_TESTS + NUM_NEGATIVE_TESTS + NUM_STREAM_TESTS)            // Incremental SAX
+            + NUM_POSITIVE_TESTS + NUM_NEGATIVE_TESTS + NUM_STREAM_TESTS + NUM_INDEXED_TESTS + 1); // Two-stage SAX
 
   // Ensure environment has no influence.
   unsetenv ("TASKDATA");
@@ -176,6 +370,32 @@ int main (int, char**)
     catch (...)                  { t.fail ("Unknown error"); }
   }
 
+  // Arena document, which must accept and reject the same input.
+  for (unsigned int i = 0; i < NUM_POSITIVE_TESTS; ++i)
+  {
+    try
+    {
+      json::document doc (positive_tests[i]);
+      t.ok (doc.root ().type () == json::j_object ||
+            doc.root ().type () == json::j_array, std::string ("document positive: ") + positive_tests[i]);
+    }
+
+    catch (const std::string& e) { t.fail (e); }
+    catch (...)                  { t.fail ("Unknown error"); }
+  }
+
+  for (unsigned int i = 0; i < NUM_NEGATIVE_TESTS; ++i)
+  {
+    try
+    {
+      json::document doc (negative_tests[i]);
+      t.fail (std::string ("document negative: ") + negative_tests[i]);
+    }
+
+    catch (const std::string& e) { t.pass (e); }
+    catch (...)                  { t.fail ("Unknown error"); }
+  }
+
   // Other tests.
   try
   {
@@ -229,10 +449,408 @@ int main (int, char**)
 
     // Escaped embedded NUL.
     t.is (json::decode ("\\\0012"), "\\\0012", "json::decode <backslash><nul>12 -> <backslash><nul>12");
+
+    // Escapes either side of, and spanning, 16- and 32-byte blocks.
+    const char* plain[] = {"abc", "\xe2\x82\xac", "\v", "x y", "0123456789abcdefghijklmnopqrstu"};
+    const char* escape[][2] = {{"\"", "\\\""}, {"\\", "\\\\"}, {"/", "\\/"}, {"\b", "\\b"},
+                               {"\f", "\\f"}, {"\n", "\\n"}, {"\r", "\\r"}, {"\t", "\\t"}};
+    std::string text;
+    std::string expected;
+    for (int i = 0; i < 200; ++i)
+    {
+      text     += plain[i % 5];
+      expected += plain[i % 5];
+      text     += escape[i % 8][0];
+      expected += escape[i % 8][1];
+    }
+    t.is (json::encode (text), expected, "json::encode long mixed text");
+    t.is (json::decode (expected), text, "json::decode long mixed text");
+
+    std::string euros;
+    for (int i = 0; i < 1000; ++i)
+      euros += "\\u20ac";
+    t.is (json::decode (euros).length (), (size_t) 3000, "json::decode 1000 <backslash>u20ac -> 3000 bytes");
   }
 
   catch (const std::string& e) {t.diag (e);}
 
+  // Object members keep insertion order, and the first duplicate wins.
+  try
+  {
+    json::value* root = json::parse ("{\"z\":1,\"a\":2,\"m\":3,\"a\":4}");
+    t.is (root->dump (), "{\"z\":1,\"a\":2,\"m\":3}", "object: dump preserves member order");
+
+    auto& members = ((json::object*) root)->_data;
+    t.is ((int) members.size (), 3,                            "object: duplicate member ignored");
+    t.is ((int) members.count ("m"), 1,                        "object: count 'm' -> 1");
+    t.ok (members.find ("q") == members.end (),                "object: find 'q' -> end");
+    t.is (members.at ("a")->dump (), "2",                      "object: at 'a' -> 2");
+
+    members["q"] = new json::literal ();
+    t.is (members.begin ()[3].first, "q",                      "object: operator[] appends");
+    t.is ((int) members.erase ("z"), 1,                        "object: erase 'z'");
+    t.is (members.begin ()->first, "a",                        "object: erase keeps order");
+    delete root;
+
+    // Enough members to be indexed.
+    json::object obj;
+    for (int i = 0; i < 100; ++i)
+      obj._data.insert ({"k" + std::to_string (i), new json::number ()});
+
+    t.is ((int) obj._data.size (), 100,                        "object: indexed size 100");
+    t.is (obj._data.find ("k57")->first, "k57",                "object: indexed find 'k57'");
+    t.ok (obj._data.find ("k100") == obj._data.end (),         "object: indexed find 'k100' -> end");
+    t.ok (! obj._data.insert ({"k3", nullptr}).second,         "object: indexed insert duplicate refused");
+
+    delete obj._data.at ("k42");
+    obj._data.erase ("k42");
+    t.is (obj._data.begin ()[42].first, "k43",                 "object: indexed erase keeps order");
+  }
+
+  catch (const std::string& e) { t.diag (e); }
+
+  // Arena document accessors.
+  try
+  {
+    json::document doc (std::string ("{\"b\":[1,true,null],\"a\":\"x\\\"y\",\"b\":false,\"c\":{}}"));
+    const json::element& root = doc.root ();
+    t.is (doc.dump (), "{\"b\":[1,true,null],\"a\":\"x\\\"y\",\"c\":{}}",
+                                                      "document: dump preserves member order, less duplicates");
+    t.is ((int) root.size (), 3,                      "document: object size 3");
+    t.is (std::string (root.key (1)), "a",            "document: key 1 is 'a'");
+    t.is (std::string (root[1].str ()), "x\\\"y",       "document: string content is raw");
+    t.ok (root.find ("b") == &root[0],                "document: find returns the first duplicate");
+    t.ok (root.find ("missing") == nullptr,           "document: find missing -> nullptr");
+    t.is ((int) root[0].size (), 3,                   "document: array size 3");
+    t.is (root[0][0].number (), 1.0,                  "document: number 1");
+    t.ok (root[0][1].lvalue () == json::literal::truevalue, "document: literal true");
+    t.ok (root[0][2].lvalue () == json::literal::nullvalue, "document: literal null");
+    t.ok (root.find ("c")->type () == json::j_object, "document: empty object");
+    t.is ((int) root.find ("c")->size (), 0,          "document: empty object size 0");
+
+    // Duplicates are dropped as json::parse drops them, in small objects and
+    // in those large enough to be checked by hash.
+    std::string large = "{\"a\":1,\"a\":2";
+    for (int i = 0; i < 40; ++i)
+      large += ",\"k" + std::to_string (i % 20) + "\":" + std::to_string (i);
+    large += "}";
+    for (auto& input : {std::string ("{\"a\":1,\"a\":2}"), large})
+    {
+      std::unique_ptr <json::value> tree (json::parse (input));
+      t.is (json::document (input).dump (), tree->dump (), "document: duplicates dropped as by json::parse, " + std::to_string (input.length ()) + " bytes");
+    }
+  }
+
+  catch (const std::string& e) { t.diag (e); }
+
+  try
+  {
+    json::document doc ("[]");
+    doc.root ()[0];
+    t.fail ("document: index out of range throws");
+  }
+
+  catch (const std::string& e) { t.pass (e); }
+
+  // Large documents span several arena blocks.
+  std::string big = "[";
+  for (int i = 0; i < 10000; ++i)
+    big += (i ? ",{\"k\":\"" : "{\"k\":\"") + std::to_string (i) + "\"}";
+  big += "]";
+  json::document large (big);
+  t.is (std::string (large.root ()[9999].find ("k")->str ()), "9999", "document: large array intact");
+
+  // Numbers keep 64-bit integers exact.
+  {
+    std::string text = "[9007199254740993,-9223372036854775808,18446744073709551615,18446744073709551616,1.5,-0.25e1]";
+    json::value* root = json::parse (text);
+    auto& items = ((json::array*) root)->_data;
+    t.ok (((json::number*) items[0])->_kind == json::number::intvalue,  "number: 2^53+1 is an int");
+    t.ok (((json::number*) items[0])->_ivalue == 9007199254740993LL,    "number: 2^53+1 is exact");
+    t.ok (((json::number*) items[1])->_kind == json::number::intvalue,  "number: INT64_MIN is an int");
+    t.ok (((json::number*) items[2])->_kind == json::number::uintvalue, "number: UINT64_MAX is a uint");
+    t.ok (((json::number*) items[3])->_kind == json::number::realvalue, "number: 2^64 is a double");
+    t.is (((json::number*) items[5])->_dvalue, -2.5,                    "number: -0.25e1 -> -2.5");
+    t.is (root->dump (), "[9007199254740993,-9223372036854775808,18446744073709551615,18446744073709551616.000000,1.500000,-2.500000]",
+                                                                        "number: integers round-trip");
+    delete root;
+
+    json::document doc (text);
+    t.ok (doc.root ()[0].kind () == json::number::intvalue,            "document: 2^53+1 is an int");
+    t.ok (doc.root ()[0].ivalue () == 9007199254740993LL,               "document: 2^53+1 is exact");
+    t.ok (doc.root ()[2].uvalue () == 18446744073709551615ULL,          "document: UINT64_MAX is exact");
+    t.is (doc.root ()[4].number (), 1.5,                                "document: 1.5");
+    t.ok (doc.root ()[4].ivalue () == 0,                                "document: ivalue of a double is 0");
+    t.is (doc.dump (), "[9007199254740993,-9223372036854775808,18446744073709551615,18446744073709551616.000000,1.500000,-2.500000]",
+                                                                        "document: integers round-trip");
+  }
+
+  // Lazy documents and JSON Pointer.
+  for (unsigned int i = 0; i < NUM_POSITIVE_TESTS; ++i)
+    lazyTest (t, positive_tests[i]);
+
+  try
+  {
+    std::string text = "{\"uuid\":\"u-1\",\"tags\":[\"a\",\"b\\\"c\"],\"a/b\":1,\"m~n\":2,"
+                       "\"skip\":{\"deep\":[[[{\"x\":[1,2,3]}]]]},\"n\":18446744073709551615,"
+                       "\"x\\u0041\":true,\"\":null,\"list\":[10,11,12,13,14,15,16,17,18,19,20]}";
+    json::lazy_document doc (text);
+    t.is (doc.pointer ("/uuid").text (), "u-1",                  "lazy: /uuid");
+    t.is (doc.pointer ("/tags/1").text (), "b\"c",               "lazy: /tags/1 decoded");
+    t.is (std::string (doc.pointer ("/tags/1").str ()), "b\\\"c", "lazy: /tags/1 raw");
+    t.ok (! doc.pointer ("/tags/2"),                             "lazy: /tags/2 missing");
+    t.ok (! doc.pointer ("/tags/01"),                            "lazy: /tags/01 leading zero");
+    t.ok (! doc.pointer ("/tags/-"),                             "lazy: /tags/- past the end");
+    t.ok (! doc.pointer ("/tags/99999999999999999999999"),       "lazy: /tags/99999999999999999999999 too large");
+    t.is (doc.pointer ("/a~1b").number (), 1.0,                  "lazy: /a~1b");
+    t.is (doc.pointer ("/m~0n").number (), 2.0,                  "lazy: /m~0n");
+    t.is (doc.pointer ("/skip/deep/0/0/0/x/2").number (), 3.0,   "lazy: deep pointer");
+    t.ok (doc.pointer ("/n").uvalue () == 18446744073709551615ULL, "lazy: /n exact");
+    t.ok (doc.pointer ("/xA").lvalue () == json::literal::truevalue, "lazy: escaped name found");
+    t.ok (doc.pointer ("/").lvalue () == json::literal::nullvalue,   "lazy: empty name");
+    t.ok (doc.pointer ("").type () == json::j_object,            "lazy: empty pointer is the root");
+    t.ok (! doc.pointer ("/uuid/0"),                             "lazy: pointer into a string");
+    t.is ((int) doc.root ().size (), 9,                          "lazy: object size 9");
+    t.is (doc.root ().find ("list")[10].ivalue (), (long long) 20, "lazy: list[10]");
+
+    std::string keys;
+    for (auto i = doc.root ().begin (); i != doc.root ().end (); ++i)
+      keys += std::string (i.key ()) + ' ';
+    t.is (keys, "uuid tags a/b m~n skip n x\\u0041  list ",   "lazy: iteration in order");
+  }
+
+  catch (const std::string& e) { t.fail (e); }
+
+  for (auto bad : {"[1,2", "[1,2}", "{\"a\":1}]", "[\"open]", "", "[1] 2", "]"})
+  {
+    try
+    {
+      json::lazy_document doc (bad);
+      t.fail (std::string ("lazy: '") + bad + "' throws");
+    }
+
+    catch (const std::string& e) { t.pass (std::string ("lazy: '") + bad + "' --> " + e); }
+  }
+
+  // Roots and numbers that json::parse rejects.  Numbers are checked when read.
+  for (auto bad : {"5", "\"x\"", "[inf]", "[nan]", "[-Infinity]", "[.5]", "[1e]", "{\"a\":+}"})
+  {
+    try
+    {
+      std::string visited;
+      json::Writer writer (visited);
+      lazyWrite (writer, json::lazy_document (bad).root ());
+      t.fail (std::string ("lazy: '") + bad + "' throws");
+    }
+
+    catch (const std::string& e) { t.pass (std::string ("lazy: '") + bad + "' --> " + e); }
+  }
+
+  // Errors within the structure surface when that part is visited.
+  try
+  {
+    json::lazy_document doc ("{\"a\":[1 2],\"b\" 3}");
+    t.is (doc.pointer ("/c").type (), json::j_value,             "lazy: a missing name is found first");
+    t.fail ("lazy: missing ':' throws");
+  }
+
+  catch (const std::string& e) { t.pass ("lazy: missing ':' --> " + e); }
+
+  try
+  {
+    json::lazy_document doc ("[1 2]");
+    doc.root ().size ();
+    t.fail ("lazy: missing ',' throws");
+  }
+
+  catch (const std::string& e) { t.pass ("lazy: missing ',' --> " + e); }
+
+  // JSON Lines, with blank, failing and CRLF lines, and no final newline.
+  try
+  {
+    std::string lines = "{\"a\":1}\n\n  \n[true]\r\n{bad}\n{\"b\":\"x\"}";
+    std::vector <json::ndjson::failure> failures;
+    auto values = json::ndjson (2).parse (lines, failures);
+    t.is ((int) values.size (), 6,                               "ndjson: one value per line");
+    t.is (values[0] ? values[0]->dump () : "", "{\"a\":1}",      "ndjson: line 1");
+    t.ok (! values[1] && ! values[2],                            "ndjson: blank lines are nullptr");
+    t.is (values[3] ? values[3]->dump () : "", "[true]",         "ndjson: CRLF line");
+    t.ok (! values[4],                                           "ndjson: failed line is nullptr");
+    t.is (values[5] ? values[5]->dump () : "", "{\"b\":\"x\"}",  "ndjson: last line without newline");
+    t.is ((int) failures.size (), 1,                             "ndjson: one failure");
+    t.is ((int) (failures.empty () ? 0 : failures[0].line), 5,   "ndjson: failure on line 5");
+
+    combined.str (std::string ());
+    ViewEventSink sink;
+    failures.clear ();
+    json::ndjson (2).parse (lines, sink, failures);
+    t.is (combined.str (), "<name>a</name><name>b</name><string>x</string>", "ndjson: SAX events of good lines only");
+    t.is ((int) failures.size (), 1,                             "ndjson: SAX failure reported");
+  }
+
+  catch (const std::string& e) { t.fail (e); }
+
+  // Many chunks across four threads keep their order and line numbers.
+  {
+    std::string lines;
+    for (int i = 0; i < 100000; ++i)
+      lines += (i % 25000 == 24999 ? std::string ("{\"id\":") : "{\"id\":" + std::to_string (i) + ",\"pad\":\"................\"}") + '\n';
+
+    std::vector <json::ndjson::failure> failures;
+    auto values = json::ndjson (4).parse (lines, failures);
+    bool ordered = values.size () == 100000;
+    for (int i = 0; ordered && i < 100000; ++i)
+      if (i % 25000 != 24999)
+        ordered = values[i] && values[i]->dump ().find ("\"id\":" + std::to_string (i) + ",") != std::string::npos;
+
+    t.ok (ordered,                                               "ndjson: 100000 lines in order");
+    t.is ((int) failures.size (), 4,                             "ndjson: 4 failures");
+    t.is ((int) (failures.size () == 4 ? failures[3].line : 0), 100000, "ndjson: last failure on line 100000");
+
+    class IdSink : public json::SAX::ViewSink
+    {
+    public:
+      void eventValueInt (int64_t value) override
+      {
+        if (_next % 25000 == 24999)
+          ++_next;
+
+        _ordered = _ordered && value == _next++;
+      }
+
+      int64_t _next    {0};
+      bool    _ordered {true};
+    } sink;
+
+    failures.clear ();
+    json::ndjson (4).parse (lines, sink, failures);
+    t.ok (sink._ordered && sink._next == 99999,                  "ndjson: SAX events in order");
+  }
+
+  // Owned, move-only nodes, built, parsed, and spliced between documents.
+  try
+  {
+    json::node task (json::j_object);
+    task.set ("id", 1);
+    task.set ("description", "Pick up \"milk\"");
+    task.set ("urgency", 4.5);
+    auto& tags = task.set ("tags", json::node (json::j_array));
+    tags.push_back ("home");
+    tags.push_back (nullptr);
+    tags.push_back (false);
+    t.is (task.dump (), "{\"id\":1,\"description\":\"Pick up \\\"milk\\\"\",\"urgency\":4.500000,\"tags\":[\"home\",null,false]}",
+                                                                 "node: built object");
+
+    task.set ("id", (uint64_t) 18446744073709551615ULL);
+    t.is ((int) task.size (), 4,                                 "node: set replaces an existing member");
+    t.ok (task.find ("id") && task.find ("id")->uvalue () == 18446744073709551615ULL, "node: uint64 kept exactly");
+
+    auto doc = json::node::parse ("{\"a\":[1,-2,\"x\\u20ac\\/\"],\"a\":0,\"b\":{}}");
+    t.is (doc.dump (), "{\"a\":[1,-2,\"x€\\/\"],\"b\":{}}",          "node: parse keeps the first duplicate");
+    t.is (std::string (doc[0][2].str ()), "x€/",              "node: strings are held decoded");
+    t.ok (doc[0][1].kind () == json::number::intvalue && doc[0][1].ivalue () == -2, "node: int64 kept exactly");
+
+    auto copy = doc.clone ();
+    auto list = doc.take ("a");
+    task.set ("list", std::move (list));
+    t.is (doc.dump (), "{\"b\":{}}",                            "node: take removes the member");
+    t.is (task.find ("list") ? task.find ("list")->dump () : "", "[1,-2,\"x€\\/\"]", "node: spliced into another node");
+    t.is (copy.dump (), "{\"a\":[1,-2,\"x€\\/\"],\"b\":{}}",          "node: clone is deep");
+
+    auto first = task.find ("list")->take ((std::size_t) 0);
+    t.is (first.dump () + task.find ("list")->dump (), "1[-2,\"x€\\/\"]", "node: take an element");
+    t.ok (! std::is_copy_constructible <json::node>::value,     "node: not copyable");
+
+    std::unique_ptr <json::value> tree (json::parse ("[{\"k\\\"\":\"v\\n\"},2.5,true]"));
+    json::node adopted (std::move (tree));
+    t.is (adopted.dump (), "[{\"k\\\"\":\"v\\n\"},2.500000,true]",          "node: adopts a json::parse tree");
+    t.is (std::string (adopted[0].key (0)), "k\"",                "node: adopted names are decoded");
+  }
+
+  catch (const std::string& e) { t.fail (e); }
+
+  for (auto& bad : {std::function <void ()> ([] () { json::node (json::j_object).push_back (1); }),
+                    std::function <void ()> ([] () { json::node (json::j_object).take ("x"); }),
+                    std::function <void ()> ([] () { json::node (json::j_array)[0]; }),
+                    std::function <void ()> ([] () { json::node::parse ("[1,]"); })})
+  {
+    try
+    {
+      bad ();
+      t.fail ("node: misuse throws");
+    }
+
+    catch (const std::string& e) { t.pass ("node: " + e); }
+  }
+
+  // Converting either kind of parsed tree gives the same node.
+  for (unsigned int i = 0; i < NUM_POSITIVE_TESTS; ++i)
+  {
+    try
+    {
+      std::unique_ptr <json::value> tree (json::parse (positive_tests[i]));
+      t.is (json::node::parse (positive_tests[i]).dump (), json::node (std::move (tree)).dump (),
+            std::string ("node: parse matches json::parse ") + positive_tests[i]);
+    }
+
+    catch (const std::string& e) { t.fail (e); }
+  }
+
+  // Writer, compact and indented, to a string and to a stream.
+  {
+    std::string compact;
+    json::Writer writer (compact);
+    writer.beginObject ();
+    writer.key ("a/b");
+    writer.value ("x\"y\n");
+    writer.key ("list");
+    writer.beginArray ();
+    writer.value (1.5);
+    writer.value (true);
+    writer.null ();
+    writer.beginObject ();
+    writer.endObject ();
+    writer.endArray ();
+    writer.endObject ();
+    t.is (compact, "{\"a\\/b\":\"x\\\"y\\n\",\"list\":[1.500000,true,null,{}]}", "writer: compact, encoded");
+
+    std::string pretty;
+    json::Writer indented (pretty, 2);
+    indented.beginObject ();
+    indented.key ("a");
+    indented.beginArray ();
+    indented.value (false);
+    indented.beginArray ();
+    indented.endArray ();
+    indented.endArray ();
+    indented.key ("b");
+    indented.null ();
+    indented.endObject ();
+    t.is (pretty, "{\n  \"a\": [\n    false,\n    []\n  ],\n  \"b\": null\n}", "writer: indented");
+
+    std::stringstream out;
+    {
+      json::Writer streamed (out);
+      streamed.beginArray ();
+      for (int i = 0; i < 10000; ++i)
+        streamed.value ("0123456789");
+      streamed.endArray ();
+    }
+    t.is ((int) out.str ().length (), 2 + 10000 * 13 - 1, "writer: stream output complete");
+  }
+
+  {
+    std::string text = "{\"b\":[1,true,null],\"a\":\"x\\\"y\",\"c\":{}}";
+    json::value* root = json::parse (text);
+    json::document doc (text);
+    t.is (root->dump (), doc.dump (), "writer: value and document dump agree");
+
+    std::string appended = "prefix ";
+    doc.root ().dump (appended);
+    t.is (appended, "prefix " + doc.dump (), "writer: element dump appends");
+    delete root;
+  }
+
   // SAX tests.
   saxTest (t,
            "{}",
@@ -247,6 +865,52 @@ int main (int, char**)
            "[1,\"2\",true,null]",
            "<doc><array><int>1</int><string>2</string><bool>true</bool><null /></array></doc>");
 
+  // SAX with string_view events, with and without escapes.
+  try
+  {
+    combined.str (std::string ());
+    ViewEventSink sink;
+    json::SAX sax;
+    sax.parse ("{\"plain\":\"a\\tb\\u20ac\",\"x\\\"y\":\"\"}", sink);
+    t.is (combined.str (), "<name>plain</name><string>a\tb€</string><name>x\"y</name><string></string>", "sax: ViewSink events");
+
+    combined.str (std::string ());
+    json::SAX::Stream stream (sink);
+    stream.feed ("[\"a\\nb\"]", 8);
+    stream.finish ();
+    t.is (combined.str (), "<string>a\nb</string>", "stream: ViewSink events");
+  }
+
+  catch (const std::string& e) { t.fail (e); }
+
+  // Incremental SAX tests.
+  for (std::size_t chunk : {(std::size_t) 1, (std::size_t) 7, (std::size_t) 4096})
+  {
+    for (unsigned int i = 0; i < NUM_POSITIVE_TESTS; ++i)
+      streamTest (t, positive_tests[i], chunk);
+
+    for (unsigned int i = 0; i < NUM_NEGATIVE_TESTS; ++i)
+      streamTest (t, negative_tests[i], chunk);
+
+    for (unsigned int i = 0; i < NUM_STREAM_TESTS; ++i)
+      streamTest (t, stream_tests[i], chunk);
+  }
+
+  // Two-stage SAX tests.
+  for (unsigned int i = 0; i < NUM_POSITIVE_TESTS; ++i)
+    indexedTest (t, positive_tests[i]);
+
+  for (unsigned int i = 0; i < NUM_NEGATIVE_TESTS; ++i)
+    indexedTest (t, negative_tests[i]);
+
+  for (unsigned int i = 0; i < NUM_STREAM_TESTS; ++i)
+    indexedTest (t, stream_tests[i]);
+
+  for (unsigned int i = 0; i < NUM_INDEXED_TESTS; ++i)
+    indexedTest (t, indexed_tests[i]);
+
+  indexedTest (t, std::string ("[\"a\0b\"]", 7));
+
   return 0;
 }
 
@@ -0,0 +1,445 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <FS.h>
+#include <JSON.h>
+#include <Timer.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <sys/resource.h>
+
+// Every allocation in the program is counted, and the bytes live tracked, so
+// that each benchmark can report its allocations and peak heap.  Each block
+// carries its size in a header, which keeps the default alignment.
+static const std::size_t header = alignof (std::max_align_t);
+
+static std::atomic <std::size_t> allocations {0};
+static std::atomic <std::size_t> live        {0};
+static std::atomic <std::size_t> peak        {0};
+
+////////////////////////////////////////////////////////////////////////////////
+void* operator new (std::size_t size)
+{
+  auto block = static_cast <char*> (std::malloc (size + header));
+  if (! block)
+    throw std::bad_alloc ();
+
+  std::memcpy (block, &size, sizeof (size));
+  ++allocations;
+  auto now = live += size;
+  for (auto high = peak.load (); now > high && ! peak.compare_exchange_weak (high, now); )
+    ;
+
+  return block + header;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete (void* pointer) noexcept
+{
+  if (! pointer)
+    return;
+
+  auto block = static_cast <char*> (pointer) - header;
+  std::size_t size;
+  std::memcpy (&size, block, sizeof (size));
+  live -= size;
+  std::free (block);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete (void* pointer, std::size_t) noexcept
+{
+  operator delete (pointer);
+}
+
+// One row of results.
+struct Result
+{
+  std::string name;
+  std::size_t bytes;        // Input size.
+  double      mbps;
+  double      allocations;  // Per iteration.
+  std::size_t peak;         // Heap bytes, above what was live before.
+};
+
+static std::vector <Result> results;
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string record (int i)
+{
+  return "{\"id\":" + std::to_string (i) +
+         ",\"description\":\"Task number " + std::to_string (i) + "\""
+         ",\"entry\":\"20260101T120000Z\",\"modified\":\"20260102T120000Z\""
+         ",\"project\":\"home\",\"status\":\"pending\",\"urgency\":4.5"
+         ",\"tags\":[\"one\",\"two\"],\"uuid\":\"11111111-1111-1111-1111-111111111111\"}";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Builds roughly 1MB of task-export-like records, which is the case that
+// matters: one large document with many small objects.
+static std::string export_corpus ()
+{
+  std::string text = "[";
+  for (int i = 0; text.length () < 1024 * 1024; ++i)
+  {
+    if (i)
+      text += ",\n";
+
+    text += record (i);
+  }
+
+  return text + "]";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The same records, one per line, as JSON Lines, in roughly 8MB.
+static std::string lines_corpus ()
+{
+  std::string text;
+  for (int i = 0; text.length () < 8 * 1024 * 1024; ++i)
+    text += record (i) + '\n';
+
+  return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Roughly 1MB of descriptions and annotations, as exported: mostly plain text,
+// with the odd quote, slash or newline to escape.
+static std::string text_corpus ()
+{
+  const char* lines[] = {
+    "Call the plumber about the kitchen sink before the weekend",
+    "Review the \"quarterly\" report and send comments to the team",
+    "Pick up groceries: milk, eggs, bread, coffee and the usual fruit",
+    "Renew the domain at example.com/account before it expires\n",
+    "Finish chapter three of the manual, then update the index",
+  };
+
+  std::string text;
+  for (int i = 0; text.length () < 1024 * 1024; ++i)
+    text += lines[i % 5];
+
+  return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Builds, and destroys, the records of the export corpus as a json::value tree.
+static std::size_t build_values (int count)
+{
+  auto text = [] (const std::string& value) { return new json::string (value); };
+  auto root = new json::array ();
+  for (int i = 0; i < count; ++i)
+  {
+    auto id = new json::number ();
+    id->_dvalue = i;
+    id->_ivalue = i;
+    id->_kind   = json::number::intvalue;
+
+    auto urgency = new json::number ();
+    urgency->_dvalue = 4.5;
+
+    auto tags = new json::array ();
+    tags->_data.push_back (text ("one"));
+    tags->_data.push_back (text ("two"));
+
+    auto task = new json::object ();
+    task->_data["id"]          = id;
+    task->_data["description"] = text ("Task number " + std::to_string (i));
+    task->_data["entry"]       = text ("20260101T120000Z");
+    task->_data["modified"]    = text ("20260102T120000Z");
+    task->_data["project"]     = text ("home");
+    task->_data["status"]      = text ("pending");
+    task->_data["urgency"]     = urgency;
+    task->_data["tags"]        = tags;
+    task->_data["uuid"]        = text ("11111111-1111-1111-1111-111111111111");
+    root->_data.push_back (task);
+  }
+
+  auto size = root->_data.size ();
+  delete root;
+  return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The same, as json::node.
+static std::size_t build_nodes (int count)
+{
+  json::node root (json::j_array);
+  root.reserve (count);
+  for (int i = 0; i < count; ++i)
+  {
+    auto& task = root.push_back (json::node (json::j_object));
+    task.reserve (9);
+    task.set ("id",          i);
+    task.set ("description", "Task number " + std::to_string (i));
+    task.set ("entry",       "20260101T120000Z");
+    task.set ("modified",    "20260102T120000Z");
+    task.set ("project",     "home");
+    task.set ("status",      "pending");
+    task.set ("urgency",     4.5);
+    auto& tags = task.set ("tags", json::node (json::j_array));
+    tags.push_back ("one");
+    tags.push_back ("two");
+    task.set ("uuid",        "11111111-1111-1111-1111-111111111111");
+  }
+
+  return root.size ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Parses and destroys the document repeatedly, and reports the throughput in
+// MB/s, including teardown, with the allocations and peak heap per document.
+template <typename F>
+static void measure (const std::string& name, const std::string& text, F function)
+{
+  // Small files are repeated to process at least 20MB.
+  int iterations = std::max (20, (int) (20 * 1024 * 1024 / std::max ((std::size_t) 1, text.length ())));
+  unsigned long long sink = 0;
+
+  auto before = live.load ();
+  peak = before;
+  allocations = 0;
+
+  Timer timer;
+  for (int i = 0; i < iterations; ++i)
+    sink += function (text);
+  timer.stop ();
+
+  double mb = (double) text.length () * iterations / (1024 * 1024);
+  results.push_back ({name,
+                      text.length (),
+                      mb / (timer.total_us () / 1e6),
+                      (double) allocations / iterations,
+                      peak - before});
+
+  auto& result = results.back ();
+  std::cout << std::left  << std::setw (32) << name
+            << std::right << std::setw (10) << std::fixed << std::setprecision (1)
+            << result.mbps << " MB/s"
+            << std::setw (12) << std::setprecision (1) << result.allocations << " allocs"
+            << std::setw (10) << result.peak / 1024 << " KB peak"
+            << "  (" << sink << ")\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::size_t peak_rss_kb ()
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes the results as JSON, for comparison between releases.
+static void report (const std::string& path)
+{
+  std::ofstream out (path);
+  json::Writer writer (out, 2);
+  writer.beginObject ();
+  writer.key ("peak_rss_kb");
+  writer.value ((uint64_t) peak_rss_kb ());
+  writer.key ("results");
+  writer.beginArray ();
+  for (const auto& result : results)
+  {
+    writer.beginObject ();
+    writer.key ("name");              writer.value (result.name);
+    writer.key ("bytes");             writer.value ((uint64_t) result.bytes);
+    writer.key ("mb_per_s");          writer.value (result.mbps);
+    writer.key ("allocations");       writer.value (result.allocations);
+    writer.key ("peak_heap_bytes");   writer.value ((uint64_t) result.peak);
+    writer.endObject ();
+  }
+
+  writer.endArray ();
+  writer.endObject ();
+  writer.raw ("\n");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Usage: json_bench [--json results.json] [file.json ...]
+int main (int argc, char** argv)
+{
+  std::vector <std::pair <std::string, std::string>> inputs;
+  inputs.push_back ({"export", export_corpus ()});
+
+  std::string output;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string (argv[i]) == "--json" && i + 1 < argc)
+    {
+      output = argv[++i];
+      continue;
+    }
+
+    std::string text;
+    if (! File::read (argv[i], text))
+    {
+      std::cerr << "Could not read " << argv[i] << '\n';
+      return 1;
+    }
+
+    // The corpus includes deliberately malformed files, which are skipped.
+    try
+    {
+      delete json::parse (text);
+      inputs.push_back ({File (argv[i]).name (), text});
+    }
+
+    catch (const std::string&) {}
+  }
+
+  // String escaping, as done for every exported field.
+  auto text = text_corpus ();
+  measure ("text json::encode", text, [] (const std::string& text)
+  {
+    return json::encode (text).length ();
+  });
+
+  auto encoded = json::encode (text);
+  measure ("text json::decode", encoded, [] (const std::string& text)
+  {
+    return json::decode (text).length ();
+  });
+
+  // Building a document in code, measured against the size of its export.
+  auto records = (int) std::count (inputs[0].second.begin (), inputs[0].second.end (), '\n') + 1;
+  measure ("export build json::value", inputs[0].second, [records] (const std::string&)
+  {
+    return build_values (records);
+  });
+
+  measure ("export build json::node", inputs[0].second, [records] (const std::string&)
+  {
+    return build_nodes (records);
+  });
+
+  // JSON Lines, one line at a time on one thread, and then across threads.
+  auto lines = lines_corpus ();
+  measure ("lines json::parse per line", lines, [] (const std::string& text)
+  {
+    std::size_t count = 0;
+    std::string line;
+    for (std::size_t start = 0, end; start < text.length (); start = end + 1)
+    {
+      end = text.find ('\n', start);
+      line.assign (text, start, end - start);
+      delete json::parse (line);
+      ++count;
+    }
+
+    return count;
+  });
+
+  auto cores = std::thread::hardware_concurrency ();
+  for (unsigned int threads = 1; threads <= std::max (1u, cores); threads *= 2)
+  {
+    measure ("lines json::ndjson " + std::to_string (threads) + " thread(s)", lines, [threads] (const std::string& text)
+    {
+      std::vector <json::ndjson::failure> failures;
+      return json::ndjson (threads).parse (text, failures).size ();
+    });
+  }
+
+  for (const auto& input : inputs)
+  {
+    measure (input.first + " json::parse", input.second, [] (const std::string& text)
+    {
+      json::value* root = json::parse (text);
+      auto type = root->type ();
+      delete root;
+      return type;
+    });
+
+    measure (input.first + " json::document", input.second, [] (const std::string& text)
+    {
+      json::document doc (text);
+      return doc.root ().type ();
+    });
+
+    measure (input.first + " json::SAX", input.second, [] (const std::string& text)
+    {
+      json::SAX::ViewSink sink;
+      json::SAX sax;
+      return sax.parse (text, sink);
+    });
+
+    measure (input.first + " json::SAX indexed", input.second, [] (const std::string& text)
+    {
+      json::SAX::ViewSink sink;
+      json::SAX sax;
+      return sax.parseIndexed (text, sink);
+    });
+
+    // Reading a few fields, which only indexes the rest.
+    measure (input.first + " json::lazy_document", input.second, [] (const std::string& text)
+    {
+      json::lazy_document doc (text);
+      return doc.pointer ("/0/uuid").str ().length () +
+             doc.pointer ("/0/status").str ().length () +
+             doc.pointer ("/0/tags/0").str ().length ();
+    });
+
+    // Serialization of a parsed tree, measured against the size of its input.
+    json::value* tree = json::parse (input.second);
+    measure (input.first + " json::value::dump", input.second, [tree] (const std::string&)
+    {
+      return tree->dump ().length ();
+    });
+    delete tree;
+
+    // The whole document as one string, which has the escapes of all its
+    // strings and the quotes and slashes around them.
+    measure (input.first + " json::encode", input.second, [] (const std::string& text)
+    {
+      return json::encode (text).length ();
+    });
+
+    measure (input.first + " json::decode", input.second, [] (const std::string& text)
+    {
+      return json::decode (text).length ();
+    });
+  }
+
+  std::cout << "Peak RSS " << peak_rss_kb () << " KB\n";
+  if (output != "")
+    report (output);
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
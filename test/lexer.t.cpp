@@ -32,7 +32,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (559);
+  UnitTest t (571);
 
   std::vector <std::pair <std::string, Lexer::Type>> tokens;
   std::string token;
@@ -218,6 +218,7 @@ int main (int, char**)
     { "9th",                                          { { "9th",                                          Lexer::Type::date         }, NO, NO, NO, NO }, },
     { "10th",                                         { { "10th",                                         Lexer::Type::date         }, NO, NO, NO, NO }, },
     { "today",                                        { { "today",                                        Lexer::Type::date         }, NO, NO, NO, NO }, },
+    { "€ 2015-02-17",                                 { { "€",                                            Lexer::Type::word         }, { "2015-02-17",                                   Lexer::Type::date         }, NO, NO, NO }, },
 
     // Duration
     { "year",                                         { { "year",                                         Lexer::Type::duration     }, NO, NO, NO, NO }, },
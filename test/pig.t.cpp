@@ -30,7 +30,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (180);
+  UnitTest t (196);
 
   // Pig::skip
   // Pig::skipN
@@ -138,6 +138,11 @@ int main (int, char**)
   t.is (dvalue, 2.34e-5, 1e-6,  "getNumber '2.34e-5' --> 2.34e-5 +/- 1e-6");
   t.ok (p10.dump ().find (" 7/7") != std::string::npos, "dump: " + p10.dump ());
 
+  Pig p10a ("-12345678901234567890 ");
+  std::string_view view;
+  t.ok (p10a.getNumber (view),                   "getNumber '-12345678901234567890 ' --> true");
+  t.is (std::string (view), "-12345678901234567890", "getNumber '-12345678901234567890 ' --> view");
+
   // Pig::getRemainder
   Pig p11 ("123");
   t.ok (p11.skipN (1),       "skipN=1 '123' --> true");
@@ -335,6 +340,29 @@ int main (int, char**)
   t.ok (p32.dump ().find (" 3/3") != std::string::npos, "dump: " + p32.dump ());
   t.ok (p32.eos (),           "eos --> true");
 
+  // Pig::Pig (std::string_view) borrows the text, which need not be terminated.
+  std::string buffer ("one two3456");
+  Pig p33 {std::string_view (buffer.data (), 7)};
+  t.ok (p33.getUntilWS (value),   "borrowed getUntilWS 'one two' --> true");
+  t.is (value, "one",             "borrowed getUntilWS 'one two' --> 'one'");
+  t.ok (p33.skipWS (),            "borrowed skipWS ' two' --> true");
+  t.ok (p33.getRemainder (value), "borrowed getRemainder 'two' --> true");
+  t.is (value, "two",             "borrowed getRemainder 'two' --> 'two'");
+  t.ok (p33.eos (),               "borrowed eos --> true");
+  t.ok (p33.dump ().find (" 7/7") != std::string::npos, "dump: " + p33.dump ());
+
+  Pig p34 {std::string_view (buffer.data () + 7, 3)};
+  t.ok (p34.getDigits (n),        "borrowed getDigits '345' --> true");
+  t.is (n, 345,                   "borrowed getDigits '345' --> 345");
+
+  // Pig::seek
+  Pig p35 ("€12");
+  t.ok (p35.seek (3),             "seek=3 '€12' --> true");
+  t.ok (p35.getDigits (n),        "seek=3 '€12' getDigits --> true");
+  t.is (n, 12,                    "seek=3 '€12' getDigits --> 12");
+  t.notok (p35.seek (6),          "seek=6 '€12' --> false");
+  t.is ((int)p35.cursor (), 5,    "seek=6 '€12' cursor --> 5");
+
   return 0;
 }
 
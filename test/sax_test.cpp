@@ -25,10 +25,31 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <JSON.h>
+#include <Timer.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <new>
 #include <sstream>
 
+// Every allocation in the process is counted, for the -b benchmark.
+static unsigned long long allocations = 0;
+
+void* operator new (std::size_t size)
+{
+  ++allocations;
+  if (void* p = std::malloc (size ? size : 1))
+    return p;
+
+  throw std::bad_alloc ();
+}
+
+void operator delete (void* p) noexcept               { std::free (p); }
+void operator delete (void* p, std::size_t) noexcept  { std::free (p); }
+
 class EventSink : public json::SAX::Sink
 {
 public:
@@ -45,17 +66,81 @@ public:
   void eventValueString (const std::string& value) override { std::cout << "# value '" << value << "'\n";                      }
 };
 
+// Sinks that do the least possible, so that the parser is measured.
+class CountingSink : public json::SAX::Sink
+{
+public:
+  void eventName (const std::string& value) override        { total += value.length (); }
+  void eventValueString (const std::string& value) override { total += value.length (); }
+  unsigned long long total {0};
+};
+
+class CountingViewSink : public json::SAX::ViewSink
+{
+public:
+  void eventName (std::string_view value) override        { total += value.length (); }
+  void eventValueString (std::string_view value) override { total += value.length (); }
+  unsigned long long total {0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Parses the input repeatedly, and reports throughput and allocations.
+template <typename S>
+static void bench (const std::string& name, const std::string& input, bool indexed = false)
+{
+  const int iterations = std::max (10, (int) (20 * 1024 * 1024 / std::max ((std::size_t) 1, input.length ())));
+
+  S sink;
+  json::SAX sax;
+  auto before = allocations;
+  Timer timer;
+  for (int i = 0; i < iterations; ++i)
+    if (indexed)
+      sax.parseIndexed (input, sink);
+    else
+      sax.parse (input, sink);
+  timer.stop ();
+
+  double mb = (double) input.length () * iterations / (1024 * 1024);
+  std::cout << std::left  << std::setw (36) << name
+            << std::right << std::setw (10) << std::fixed << std::setprecision (1)
+            << mb / (timer.total_us () / 1e6) << " MB/s"
+            << std::setw (12) << (allocations - before) / iterations << " allocations\n";
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int main (int argc, char** argv)
 {
   int status = 0;
   if (argc == 1)
   {
-    std::cout << "\nUsage: json2_test <file> ...\n"
+    std::cout << "\nUsage: json2_test [-b] <file> ...\n"
               << '\n'
+              << "      -b        benchmark Sink, ViewSink and indexed parsing\n"
               << "      <file>    file containing JSON\n"
               << '\n';
   }
+  else if (! strcmp (argv[1], "-b"))
+  {
+    for (int i = 2; i < argc; ++i)
+    {
+      try
+      {
+        std::ifstream inputFile (argv[i]);
+        std::stringstream input;
+        input << inputFile.rdbuf ();
+
+        std::string name = argv[i];
+        name = name.substr (name.rfind ('/') + 1);
+        bench <CountingSink>     (name + " Sink",     input.str ());
+        bench <CountingViewSink> (name + " ViewSink", input.str ());
+        bench <CountingViewSink> (name + " ViewSink indexed", input.str (), true);
+      }
+
+      catch (const std::string& e) { std::cout << e << '\n';         }
+      catch (...)                  { std::cout << "Unknown error\n"; }
+    }
+  }
   else
   {
     for (int i = 1; i < argc; ++i)
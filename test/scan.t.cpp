@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <cstring>
+#include <scan.h>
+#include <string>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string structure (const std::string& input)
+{
+  std::vector <uint32_t> index;
+  scan_json_structure (input.data (), input.length (), index);
+
+  std::string result;
+  for (auto offset : index)
+    result += (result.empty () ? "" : ",") + std::to_string (offset);
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The index that scan_json_structure should produce, one byte at a time.
+static std::string reference (const std::string& input)
+{
+  std::string result;
+  auto add = [&] (std::size_t offset) { result += (result.empty () ? "" : ",") + std::to_string (offset); };
+
+  bool in_string = false;
+  bool escape = false;
+  bool scalar = false;
+  for (std::size_t i = 0; i < input.length (); ++i)
+  {
+    char c = input[i];
+    bool escaped = escape;
+    escape = ! escaped && c == '\\';
+
+    if (in_string)
+    {
+      if (c == '"' && ! escaped)
+      {
+        in_string = false;
+        add (i);
+      }
+    }
+    else if (c == '"' && ! escaped)
+    {
+      in_string = true;
+      scalar = false;
+      add (i);
+    }
+    else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',')
+    {
+      scalar = false;
+      add (i);
+    }
+    else if (c == ' ' || (c >= '\t' && c <= '\r'))
+      scalar = false;
+    else
+    {
+      if (! scalar)
+        add (i);
+
+      scalar = true;
+    }
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (26);
+
+  // Runs are chosen to end before, within and after a 16- and 32-byte block.
+  std::string spaces = std::string (40, ' ') + "\t\n\v\f\rx";
+  t.is (scan_ascii_space (spaces.data (), 0),              (size_t) 0, "scan_ascii_space '' --> 0");
+  t.is (scan_ascii_space (spaces.data (), 7),              (size_t) 7, "scan_ascii_space 7 spaces --> 7");
+  t.is (scan_ascii_space (spaces.data (), spaces.size ()), (size_t) 45, "scan_ascii_space 45 whitespace, x --> 45");
+  t.is (scan_ascii_space ("x ", 2),                        (size_t) 0, "scan_ascii_space 'x ' --> 0");
+  t.is (scan_ascii_space ("\xc2\xa0", 2),                  (size_t) 0, "scan_ascii_space U+00A0 --> 0");
+
+  std::string digits = std::string (20, '7') + "/" + std::string (20, '0') + ":";
+  t.is (scan_ascii_digit (digits.data (), digits.size ()),          (size_t) 20, "scan_ascii_digit 20 digits, / --> 20");
+  t.is (scan_ascii_digit (digits.data () + 21, digits.size () - 21), (size_t) 20, "scan_ascii_digit 20 digits, : --> 20");
+  t.is (scan_ascii_digit ("0123456789", 10),                        (size_t) 10, "scan_ascii_digit 0-9 --> 10");
+
+  std::string word = std::string (33, 'a') + "\xe2\x82\xac";
+  t.is (scan_ascii_nonspace (word.data (), word.size ()), (size_t) 33, "scan_ascii_nonspace 33 a, € --> 33");
+  t.is (scan_ascii_nonspace ("one two", 7),               (size_t) 3,  "scan_ascii_nonspace 'one two' --> 3");
+  t.is (scan_ascii_nonspace ("one\ttwo", 7),              (size_t) 3,  "scan_ascii_nonspace 'one\\ttwo' --> 3");
+  t.is (scan_ascii_nonspace (std::string ("ab\0c", 4).data (), 4), (size_t) 2, "scan_ascii_nonspace 'ab\\0c' --> 2");
+  t.is (scan_ascii_nonspace ("!~", 2),                    (size_t) 2,  "scan_ascii_nonspace '!~' --> 2");
+
+  std::string quoted = std::string (17, 'q') + "\\\"" + std::string (30, 'q') + "\"";
+  t.is (scan_until (quoted.data (), quoted.size (), '"', '\\'),           (size_t) 17, "scan_until '\"' '\\' --> 17");
+  t.is (scan_until (quoted.data () + 19, quoted.size () - 19, '"', '\\'), (size_t) 30, "scan_until '\"' '\\' --> 30");
+  t.is (scan_until (quoted.data (), 10, '"', '\\'),                       (size_t) 10, "scan_until '\"' '\\', no delimiter --> 10");
+  t.is (scan_until ("abc", 3, 'b', 'b'),                                  (size_t) 1,  "scan_until 'b' 'b', 'abc' --> 1");
+  t.is (scan_until ("\xff" "abc", 4, 'c', 'c'),                           (size_t) 3,  "scan_until 'c' 'c', '\\xffabc' --> 3");
+
+  // Every byte value, at an offset within the second 32-byte block.
+  std::string plain = std::string (40, 'p') + "\v" + std::string (7, 'p');
+  t.is (scan_json_plain (plain.data (), plain.size ()),  (size_t) 48, "scan_json_plain 40 p, \\v, 7 p --> 48");
+  t.is (scan_json_plain ("Task \"home\"", 11),         (size_t) 5,  "scan_json_plain 'Task \"home\"' --> 5");
+  t.is (scan_json_plain ("\xe2\x82\xac/", 4),         (size_t) 3,  "scan_json_plain '€/' --> 3");
+
+  int escapes = 0;
+  for (int c = 0; c < 256; ++c)
+  {
+    plain[40] = (char) c;
+    auto expected = strchr ("\"\\/\b\f\n\r\t", c) && c ? (size_t) 40 : (size_t) 48;
+    if (scan_json_plain (plain.data (), plain.size ()) != expected)
+      ++escapes;
+  }
+  t.is (escapes, 0,                                        "scan_json_plain stops at exactly the bytes json::encode escapes");
+
+  // JSON structural index.
+  t.is (structure ("{\"a\":[1, true]}"), "0,1,3,4,5,6,7,9,13,14", "scan_json_structure object, array, scalars");
+  t.is (structure ("[\"x\\\"{\\\\\",-1]"), "0,1,8,9,10,12",      "scan_json_structure escapes in a string");
+
+  // A backslash that ends a block escapes the first byte of the next.
+  std::string boundary = "[\"" + std::string (61, 'x') + "\\\"\"]";
+  t.is (structure (boundary), reference (boundary),                     "scan_json_structure escape across blocks");
+
+  int mismatches = 0;
+  const char alphabet[] = "{}[]:,\"\\ \nat1-";
+  for (int trial = 0; trial < 200; ++trial)
+  {
+    std::string input;
+    for (int i = 0; i < 300; ++i)
+      input += alphabet[std::rand () % (sizeof (alphabet) - 1)];
+
+    if (structure (input) != reference (input))
+      ++mismatches;
+  }
+  t.is (mismatches, 0,                                                  "scan_json_structure random input matches reference");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
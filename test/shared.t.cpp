@@ -30,7 +30,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (211);
+  UnitTest t (218);
 
   // void wrapText (std::vector <std::string>& lines, const std::string& text, const int width, bool hyphenate)
   std::string text = "This is a test of the line wrapping code.";
@@ -381,6 +381,16 @@ int main (int, char**)
   t.is ((int) find ("one two three", "e",  3, false), (int) 11,    "find offset obeyed");
   t.is ((int) find ("one two three", "e", 11, false), (int) 11,    "find offset obeyed");
 
+  // bool parseDouble (std::string_view, double&);
+  double number;
+  t.ok (parseDouble ("-1.25e2", number),                           "parseDouble -1.25e2 --> true");
+  t.is (number, -125.0,                                            "parseDouble -1.25e2 --> -125");
+  t.ok (parseDouble ("+0.5", number),                              "parseDouble +0.5 --> true");
+  t.is (number, 0.5,                                               "parseDouble +0.5 --> 0.5");
+  t.ok (parseDouble ("1e999", number) && number > 1e308,           "parseDouble 1e999 --> capped");
+  t.notok (parseDouble ("1.5x", number),                           "parseDouble 1.5x --> false");
+  t.notok (parseDouble ("", number),                               "parseDouble '' --> false");
+
   // Test osName actually recognizes OS.
   t.ok (osName () != "<unknown>",                                  "osName: Recognizes OS as: " + osName ());
 
@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Timezone.h>
+#include <Datetime.h>
+#include <tuple>
+#include <cstdlib>
+#include <ctime>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Version 2 TZif data, with an empty version 1 block.
+static std::string tzif (
+  const std::vector <std::pair <int64_t, int>>& transitions,
+  const std::vector <std::tuple <int32_t, bool, std::string>>& types,
+  const std::string& footer)
+{
+  auto integer = [] (std::string& out, int64_t value, int bytes)
+  {
+    for (int i = bytes - 1; i >= 0; --i)
+      out += (char) ((value >> (i * 8)) & 0xff);
+  };
+
+  std::string chars;
+  for (auto& type : types)
+    chars += std::get <2> (type) + '\0';
+
+  auto header = [&] (std::string& out, int64_t times, int64_t typecnt, int64_t charcnt)
+  {
+    out += "TZif2" + std::string (15, '\0');
+    for (auto count : {0LL, 0LL, 0LL, (long long) times, (long long) typecnt, (long long) charcnt})
+      integer (out, count, 4);
+  };
+
+  std::string data;
+  header (data, 0, 0, 0);
+  header (data, transitions.size (), types.size (), chars.length ());
+  for (auto& transition : transitions)
+    integer (data, transition.first, 8);
+
+  for (auto& transition : transitions)
+    data += (char) transition.second;
+
+  std::size_t abbreviation = 0;
+  for (auto& type : types)
+  {
+    integer (data, std::get <0> (type), 4);
+    data += (char) std::get <1> (type);
+    data += (char) abbreviation;
+    abbreviation += std::get <2> (type).length () + 1;
+  }
+
+  return data + chars + '\n' + footer + '\n';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (38);
+
+  // 2024-03-31T01:00:00Z and 2024-10-27T01:00:00Z, when central Europe
+  // changed to and from summer time.
+  const time_t spring = 1711846800;
+  const time_t autumn = 1729990800;
+
+  try
+  {
+    // A zone given only by its footer rule, as "slim" TZif files are.
+    auto cet = Timezone::parse ("CET", tzif ({}, {{3600, false, "CET"}}, "CET-1CEST,M3.5.0,M10.5.0/3"));
+    t.is (cet.name (), "CET",                                 "CET: name");
+    t.is (cet.offset (1705320000), 3600,                      "CET: 2024-01-15 --> +01:00");
+    t.is (cet.offset (1721044800), 7200,                      "CET: 2024-07-15 --> +02:00");
+    t.is (cet.at (1721044800).abbreviation, "CEST",           "CET: 2024-07-15 --> CEST");
+    t.ok (cet.at (1721044800).dst,                            "CET: 2024-07-15 --> dst");
+    t.is (cet.offset (spring - 1), 3600,                      "CET: just before the spring change --> +01:00");
+    t.is (cet.offset (spring),     7200,                      "CET: at the spring change --> +02:00");
+    t.is (cet.offset (autumn - 1), 7200,                      "CET: just before the autumn change --> +02:00");
+    t.is (cet.offset (autumn),     3600,                      "CET: at the autumn change --> +01:00");
+    t.is (cet.offset (10397894400), 7200,                     "CET: 2299-07-01, beyond the listed changes --> +02:00");
+    t.is (cet.offset (379631361600), 3600,                    "CET: 14000-01-15, far beyond 9999 --> +01:00");
+    t.is (cet.offset (379647086400), 7200,                    "CET: 14000-07-15, far beyond 9999 --> +02:00");
+
+    // 02:30 local is skipped in spring, and repeated in autumn.
+    t.is (cet.toUTC (spring + 5400), spring + 1800,           "CET: skipped 02:30 --> 03:30 CEST");
+    t.is (cet.toUTC (autumn + 5400), autumn - 1800,           "CET: repeated 02:30 --> the first, in CEST");
+    t.is (cet.toLocal (spring), (int64_t) spring + 7200,      "CET: toLocal at the spring change");
+
+    int wrong = 0;
+    for (time_t when = 1577836800; when < 1893456000; when += 1800)
+      if (cet.toLocal (cet.toUTC (cet.toLocal (when))) != cet.toLocal (when))
+        ++wrong;
+    t.is (wrong, 0,                                           "CET: toUTC inverts toLocal, 2020-2030");
+
+    // Bulk conversion gives the same answers.  Times in the repeated hour come
+    // back as their first occurrence, and so are compared as local times.
+    std::vector <time_t> times;
+    for (time_t when = 1577836800; when < 1893456000; when += 86400 * 3 + 1234)
+      times.push_back (when);
+
+    std::vector <int64_t> locals;
+    std::vector <time_t> back;
+    cet.toLocal (times, locals);
+    cet.toUTC (locals, back);
+    wrong = 0;
+    for (std::size_t i = 0; i < times.size (); ++i)
+      if (locals[i] != cet.toLocal (times[i]) || cet.toLocal (back[i]) != locals[i])
+        ++wrong;
+    t.is (wrong, 0,                                           "CET: bulk toLocal and toUTC agree");
+
+    // Summer time over the new year.
+    auto sydney = Timezone::parse ("Sydney", tzif ({}, {{36000, false, "AEST"}}, "AEST-10AEDT,M10.1.0,M4.1.0/3"));
+    t.is (sydney.offset (1705320000), 39600,                  "Sydney: 2024-01-15 --> +11:00");
+    t.is (sydney.offset (1721044800), 36000,                  "Sydney: 2024-07-15 --> +10:00");
+
+    // Quoted names, and no summer time.
+    auto plus3 = Timezone::parse ("+03", tzif ({}, {{10800, false, "+03"}}, "<+03>-3"));
+    t.is (plus3.at (1721044800).abbreviation, "+03",          "<+03>-3: abbreviation");
+    t.is (plus3.offset (1721044800), 10800,                   "<+03>-3 --> +03:00");
+
+    // Listed transitions, with the first type before them, and the last one
+    // after them when there is no footer.
+    auto listed = Timezone::parse ("listed", tzif ({{1000, 1}, {2000, 2}},
+                                                   {{0, false, "LMT"}, {3600, false, "AAA"}, {7200, true, "BBB"}}, ""));
+    t.is (listed.offset (500),  0,                            "listed: before the first transition --> first type");
+    t.is (listed.offset (1500), 3600,                         "listed: between transitions");
+    t.is (listed.offset (9999), 7200,                         "listed: after the last transition");
+
+    // Datetime parses and formats in a zone given by its Context.
+    Datetime::Context context;
+    context.timezone = &cet;
+    Datetime summer ("2024-07-01T12:00:00", "", context);
+    t.is (summer.toEpoch (), (time_t) 1719828000,             "Datetime in CET: 2024-07-01T12:00:00 --> 10:00Z");
+    t.is (summer.hour (), 12,                                 "Datetime in CET: hour () --> 12");
+    Datetime winter ("2024-01-01T00:00:00Z", "", context);
+    t.is (winter.toString ("Y-M-D H:N:S"), "2024-01-01 01:00:00", "Datetime in CET: 2024-01-01T00:00:00Z --> 01:00");
+
+    // Periods start at midnight in the Context's zone, not the process's.
+    const char* tz = getenv ("TZ");
+    std::string saved = tz ? tz : "";
+    setenv ("TZ", "America/New_York", 1);
+    tzset ();
+
+    Datetime wednesday ("2024-07-03T15:00:00", "", context);
+    t.is (wednesday.startOfDay ().toEpoch (),   (time_t) 1719957600, "Datetime in CET: startOfDay --> 2024-07-03T00:00:00+02:00");
+    t.is (wednesday.startOfWeek ().toEpoch (),  (time_t) 1719698400, "Datetime in CET: startOfWeek --> 2024-06-30T00:00:00+02:00");
+    t.is (wednesday.startOfMonth ().toEpoch (), (time_t) 1719784800, "Datetime in CET: startOfMonth --> 2024-07-01T00:00:00+02:00");
+    t.is (wednesday.startOfYear ().toEpoch (),  (time_t) 1704063600, "Datetime in CET: startOfYear --> 2024-01-01T00:00:00+01:00");
+    t.is (wednesday.startOfMonth ().toString ("Y-M-D H:N:S"), "2024-07-01 00:00:00", "Datetime in CET: startOfMonth keeps the zone");
+
+    if (tz)
+      setenv ("TZ", saved.c_str (), 1);
+    else
+      unsetenv ("TZ");
+    tzset ();
+  }
+
+  catch (const std::string& error)
+  {
+    t.fail ("Exception thrown.");
+    t.diag (error);
+  }
+
+  // Bad data.
+  try { Timezone::parse ("bad", "TZif2, but nothing more"); t.fail ("parse: truncated data throws"); }
+  catch (const std::string&) { t.pass ("parse: truncated data throws"); }
+
+  try { Timezone::parse ("bad", tzif ({}, {{0, false, "UTC"}}, "UTC0,M13.1.0")); t.fail ("parse: bad footer throws"); }
+  catch (const std::string&) { t.pass ("parse: bad footer throws"); }
+
+  try { Timezone::get ("No/Such_Zone"); t.fail ("get: unknown zone throws"); }
+  catch (const std::string&) { t.pass ("get: unknown zone throws"); }
+
+  try { Timezone::get ("../etc/passwd"); t.fail ("get: '..' throws"); }
+  catch (const std::string&) { t.pass ("get: '..' throws"); }
+
+  // The installed Europe/Berlin agrees with the rule since 1996, when the
+  // current rules began.
+  try
+  {
+    auto& berlin = Timezone::get ("Europe/Berlin");
+    auto cet = Timezone::parse ("CET", tzif ({}, {{3600, false, "CET"}}, "CET-1CEST,M3.5.0,M10.5.0/3"));
+
+    int wrong = 0;
+    for (time_t when = 820454400; when < 2208988800; when += 1800)
+      if (berlin.offset (when) != cet.offset (when))
+        ++wrong;
+
+    t.is (wrong, 0, "Europe/Berlin agrees with its rule, 1996-2040");
+    t.ok (&berlin == &Timezone::get ("Europe/Berlin"), "Europe/Berlin is read once");
+  }
+
+  catch (const std::string&)
+  {
+    t.skip ("Europe/Berlin is not installed");
+    t.skip ("Europe/Berlin is not installed");
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
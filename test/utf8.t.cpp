@@ -30,7 +30,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (33);
+  UnitTest t (37);
 
   std::string ascii_text            = "This is a test";
   std::string utf8_text             = "más sábado miércoles";
@@ -52,11 +52,15 @@ int main (int, char**)
   t.is ((int) utf8_length (ascii_text),                14, "ASCII utf8_length");
   t.is ((int) utf8_length (utf8_text),                 20, "UTF8 utf8_length");
   t.is ((int) utf8_length (utf8_wide_text),             6, "UTF8 wide utf8_length");
+  t.is ((int) utf8_length (std::string (40, 'x') + utf8_wide_text), 46, "Long ASCII + UTF8 wide utf8_length");
 
   // unsigned int utf8_width (const std::string&);
   t.is ((int) utf8_width (ascii_text),                 14, "ASCII utf8_width");
   t.is ((int) utf8_width (utf8_text),                  20, "UTF8 utf8_width");
   t.is ((int) utf8_width (utf8_wide_text),             12, "UTF8 wide utf8_width");
+  t.is ((int) utf8_width ("a\tb\nc\x7f"),              3, "ASCII controls utf8_width");
+  t.is ((int) utf8_width (std::string (40, 'x') + utf8_wide_text), 52, "Long ASCII + UTF8 wide utf8_width");
+  t.is ((int) utf8_width (std::string ("ab\0cd", 5)),    2, "Embedded NUL utf8_width");
 
   // unsigned int utf8_text_length (const std::string&);
   t.is ((int) utf8_text_length (ascii_text_color),     14, "ASCII utf8_text_length");
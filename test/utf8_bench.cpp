@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Gothenburg Bit Factory.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://opensource.org/license/mit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Composite.h>
+#include <Pig.h>
+#include <Timer.h>
+#include <iomanip>
+#include <iostream>
+#include <utf8.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Builds roughly 1MB of text by repeating a sample.
+static std::string corpus (const std::string& sample)
+{
+  std::string text;
+  while (text.length () < 1024 * 1024)
+    text += sample;
+
+  return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Runs the function repeatedly, and reports the throughput in MB/s.
+template <typename F>
+static void measure (const std::string& name, const std::string& text, F function)
+{
+  const int iterations = 20;
+  unsigned long long sink = 0;
+
+  Timer timer;
+  for (int i = 0; i < iterations; ++i)
+    sink += function (text);
+  timer.stop ();
+
+  double mb = (double) text.length () * iterations / (1024 * 1024);
+  std::cout << std::left  << std::setw (28) << name
+            << std::right << std::setw (10) << std::fixed << std::setprecision (1)
+            << mb / (timer.total_us () / 1e6) << " MB/s"
+            << "  (" << sink << ")\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  struct
+  {
+    const char* name;
+    std::string text;
+  } inputs[] =
+  {
+    { "ascii",  corpus ("The quick brown fox jumps over the lazy dog. ") },
+    { "latin1", corpus ("Fjärran väster, på ängarna, där gräset är grönt. ") },
+    { "cjk",    corpus ("敏捷的棕色狐狸跳过了懒狗。日本語のテキスト。") },
+  };
+
+  for (const auto& input : inputs)
+  {
+    std::string prefix = std::string (input.name) + ' ';
+
+    measure (prefix + "utf8_next_char", input.text, [] (const std::string& text)
+    {
+      unsigned long long sum = 0;
+      std::string::size_type i = 0;
+      unsigned int c;
+      while ((c = utf8_next_char (text, i)))
+        sum += c;
+      return sum;
+    });
+
+    measure (prefix + "utf8_length", input.text, [] (const std::string& text)
+    {
+      return utf8_length (text);
+    });
+
+    measure (prefix + "utf8_width", input.text, [] (const std::string& text)
+    {
+      return utf8_width (text);
+    });
+
+    measure (prefix + "Pig::skipN", input.text, [] (const std::string& text)
+    {
+      Pig pig {std::string_view (text)};
+      unsigned long long count = 0;
+      while (pig.skipN (1000))
+        ++count;
+      return count;
+    });
+
+    measure (prefix + "Composite::str", input.text, [] (const std::string& text)
+    {
+      Composite composite;
+      composite.add (text, 0, Color ());
+      return composite.str ().length ();
+    });
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////